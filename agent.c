@@ -0,0 +1,729 @@
+/* #############################################################################
+ * code for the agent which keeps the database for repeated CLI searches
+ * #############################################################################
+ * Copyright (C) 2005-2009 Harry Brueckner
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or any later version.
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contact: Harry Brueckner <harry_b@mm.st>
+ *          Muenchener Strasse 12a
+ *          85253 Kleinberghofen
+ *          Germany
+ * #############################################################################
+ */
+
+
+/* #############################################################################
+ * includes
+ */
+#include "cpm.h"
+#include <dirent.h>
+#include <limits.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "agent.h"
+#include "configuration.h"
+#include "general.h"
+#include "interface_cli.h"
+#include "listhandler.h"
+#include "memory.h"
+#include "string.h"
+
+
+/* #############################################################################
+ * internal functions
+ */
+int agentFilePath(char* filename, char* path);
+int agentPeerCheck(int fd);
+int agentRequest(int fd);
+int agentSocketDirectory(const char* directory);
+int agentSocketPath(struct sockaddr_un* address, int create);
+int agentSocketRemove(struct sockaddr_un* address);
+
+
+/* #############################################################################
+ * global variables
+ */
+#define AGENT_BUFFERSIZE  65536
+#define AGENT_MAGIC       "cpm-agent-1"
+#define AGENT_TIMEOUT     5
+#define AGENT_TMPDIR      "/tmp"
+
+#define AGENT_OK          '0'
+#define AGENT_ERROR       '1'
+#define AGENT_REFUSED     'r'
+
+/* Flawfinder: ignore */
+char                    agentdbfile[PATH_MAX];
+/* Flawfinder: ignore */
+char                    agentrcfile[PATH_MAX];
+struct stat             agentdbstat;
+
+
+/* #############################################################################
+ *
+ * Description    get the absolute path of a file, so the client and the agent
+ *                can compare which files they use
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      char* filename  - the file to resolve
+ *                char* path      - buffer of PATH_MAX bytes for the result;
+ *                                  it's empty if the file can't be resolved
+ * Return         int 1 if the file can't be resolved, otherwise 0
+ */
+int agentFilePath(char* filename, char* path)
+  {
+    TRACE(99, "agentFilePath()", NULL);
+
+    path[0] = 0;
+    if (!filename ||
+        !realpath(filename, path))
+      {
+        path[0] = 0;
+        return 1;
+      }
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    make sure the other end of the socket runs as our user
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      int fd  - the connected socket
+ * Return         int 1 if the peer can't be trusted, otherwise 0
+ */
+int agentPeerCheck(int fd)
+  {
+#if defined(SO_PEERCRED)
+    struct ucred        credentials;
+    socklen_t           size = sizeof(credentials);
+
+    TRACE(99, "agentPeerCheck()", NULL);
+
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &size) ||
+        credentials.uid != getuid())
+      { return 1; }
+
+    return 0;
+#elif defined(HAVE_GETPEEREID)
+    uid_t               uid;
+    gid_t               gid;
+
+    TRACE(99, "agentPeerCheck()", NULL);
+
+    if (getpeereid(fd, &uid, &gid) ||
+        uid != getuid())
+      { return 1; }
+
+    return 0;
+#else
+    TRACE(99, "agentPeerCheck()", NULL);
+
+    /* without peer credentials we can't trust anybody */
+    return 1;
+#endif
+  }
+
+
+/* #############################################################################
+ *
+ * Description    ask a running agent to run the search of the commandline;
+ *                the agent writes the results directly to our stdout and
+ *                stderr, which we pass along with the request
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      int* result   - the result of the search like cliInterface()
+ *                                returns it
+ * Return         int 0 if the agent ran the search, 1 if there is no agent
+ *                for our database and we must search ourselves
+ */
+int agentQuery(int* result)
+  {
+    struct sockaddr_un  address;
+    struct msghdr       message;
+    struct iovec        vector;
+    struct cmsghdr*     control;
+    /* Flawfinder: ignore */
+    char                controlbuffer[CMSG_SPACE(2 * sizeof(int))];
+    /* Flawfinder: ignore */
+    char                path[PATH_MAX];
+    int                 fd,
+                        i,
+                        size = 0,
+                        *fds;
+    char*               buffer;
+    char                status;
+
+    TRACE(99, "agentQuery()", NULL);
+
+    if (agentSocketPath(&address, 0))
+      { return 1; }
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1)
+      { return 1; }
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) ||
+        agentPeerCheck(fd))
+      {
+        close(fd);
+        return 1;
+      }
+
+    /* the request is a list of 0-terminated fields */
+    buffer = memAlloc(__FILE__, __LINE__, AGENT_BUFFERSIZE);
+    agentFilePath(runtime -> dbfile, path);
+    size += snprintf(buffer + size, AGENT_BUFFERSIZE - size, "%s", AGENT_MAGIC) + 1;
+    size += snprintf(buffer + size, AGENT_BUFFERSIZE - size, "%s", path) + 1;
+    agentFilePath(config -> rcfile, path);
+    size += snprintf(buffer + size, AGENT_BUFFERSIZE - size, "%s", path) + 1;
+    size += snprintf(buffer + size, AGENT_BUFFERSIZE - size, "%d",
+        runtime -> searchtype) + 1;
+    size += snprintf(buffer + size, AGENT_BUFFERSIZE - size, "%d",
+        runtime -> casesensitive) + 1;
+    size += snprintf(buffer + size, AGENT_BUFFERSIZE - size, "%d",
+        listCount(config -> searchdata)) + 1;
+    for (i = 0; config -> searchdata && config -> searchdata[i]; i++)
+      {
+        if (size + strlen(config -> searchdata[i]) + 1 >= AGENT_BUFFERSIZE)
+          { break; }
+        size += snprintf(buffer + size, AGENT_BUFFERSIZE - size, "%s",
+            config -> searchdata[i]) + 1;
+      }
+    if (config -> searchdata && config -> searchdata[i])
+      {   /* the request doesn't fit, we search ourselves */
+        memFree(__FILE__, __LINE__, buffer, AGENT_BUFFERSIZE);
+        close(fd);
+        return 1;
+      }
+
+    vector.iov_base = buffer;
+    vector.iov_len = size;
+
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = controlbuffer;
+    message.msg_controllen = sizeof(controlbuffer);
+
+    control = CMSG_FIRSTHDR(&message);
+    control -> cmsg_level = SOL_SOCKET;
+    control -> cmsg_type = SCM_RIGHTS;
+    control -> cmsg_len = CMSG_LEN(2 * sizeof(int));
+    fds = (int*)CMSG_DATA(control);
+    fds[0] = STDOUT_FILENO;
+    fds[1] = STDERR_FILENO;
+
+    fflush(stdout);
+    fflush(stderr);
+    if (sendmsg(fd, &message, 0) != size)
+      {
+        memFree(__FILE__, __LINE__, buffer, AGENT_BUFFERSIZE);
+        close(fd);
+        return 1;
+      }
+    memFree(__FILE__, __LINE__, buffer, AGENT_BUFFERSIZE);
+    shutdown(fd, SHUT_WR);
+
+    /* the agent answers with a single status byte once it's done */
+    while ((i = read(fd, &status, 1)) == -1 &&
+        errno == EINTR)
+      { }
+    close(fd);
+
+    if (i != 1 ||
+        (status != AGENT_OK && status != AGENT_ERROR))
+      { return 1; }
+
+    *result = (status == AGENT_OK) ? 0 : 1;
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    handle a single request of a client
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      int fd  - the connected socket of the client
+ * Return         int 1 if the agent must quit since its database changed,
+ *                otherwise 0
+ */
+int agentRequest(int fd)
+  {
+    struct msghdr       message;
+    struct iovec        vector;
+    struct cmsghdr*     control;
+    struct stat         filestat;
+    struct timeval      timeout;
+    /* Flawfinder: ignore */
+    char                controlbuffer[CMSG_SPACE(2 * sizeof(int))];
+    int                 casesensitive,
+                        count,
+                        error,
+                        field,
+                        i,
+                        quit = 0,
+                        result,
+                        savedout,
+                        savederr,
+                        searchtype,
+                        size = 0,
+                        fds[2] = { -1, -1 };
+    char*               buffer;
+    char*               fields[6];
+    char*               ptr;
+    char                status = AGENT_REFUSED;
+
+    TRACE(99, "agentRequest()", NULL);
+
+    if (agentPeerCheck(fd))
+      { return 0; }
+
+    /* a client must not block us for long */
+    timeout.tv_sec = AGENT_TIMEOUT;
+    timeout.tv_usec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    /* we read until the client closes its side of the connection */
+    buffer = memAlloc(__FILE__, __LINE__, AGENT_BUFFERSIZE);
+    while (size < AGENT_BUFFERSIZE)
+      {
+        vector.iov_base = buffer + size;
+        vector.iov_len = AGENT_BUFFERSIZE - size;
+
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = controlbuffer;
+        message.msg_controllen = sizeof(controlbuffer);
+
+        result = recvmsg(fd, &message, 0);
+        if (result == -1 &&
+            errno == EINTR)
+          { continue; }
+        if (result <= 0)
+          { break; }
+
+        for (control = CMSG_FIRSTHDR(&message); control;
+            control = CMSG_NXTHDR(&message, control))
+          {
+            if (control -> cmsg_level != SOL_SOCKET ||
+                control -> cmsg_type != SCM_RIGHTS)
+              { continue; }
+
+            count = (control -> cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            for (i = 0; i < count; i++)
+              {
+                memcpy(&field, CMSG_DATA(control) + i * sizeof(int),
+                    sizeof(int));
+                if (i < 2 && fds[i] == -1)
+                  { fds[i] = field; }
+                else
+                  { close(field); }
+              }
+          }
+
+        size += result;
+      }
+
+    /* a request which fills the whole buffer is refused, so there always is
+     * room for a terminating 0 which keeps the search data inside of it
+     */
+    if (size < AGENT_BUFFERSIZE)
+      { buffer[size] = 0; }
+
+    /* we split the fixed fields of the request */
+    ptr = buffer;
+    for (field = 0; field < 6; field++)
+      {
+        fields[field] = ptr;
+        while (ptr < buffer + size && *ptr)
+          { ptr++; }
+        if (ptr >= buffer + size)
+          { break; }
+        ptr++;
+      }
+
+    error = (size >= AGENT_BUFFERSIZE ||
+        field < 6 ||
+        fds[0] == -1 ||
+        fds[1] == -1 ||
+        strcmp(fields[0], AGENT_MAGIC) ||
+        strcmp(fields[1], agentdbfile) ||
+        strcmp(fields[2], agentrcfile));
+
+    /* if the database changed, our copy is outdated and we quit */
+    if (!error &&
+        (stat(agentdbfile, &filestat) ||
+        filestat.st_dev != agentdbstat.st_dev ||
+        filestat.st_ino != agentdbstat.st_ino ||
+        filestat.st_size != agentdbstat.st_size ||
+        filestat.st_mtime != agentdbstat.st_mtime))
+      { error = quit = 1; }
+
+    if (!error)
+      {
+        searchtype = atoi(fields[3]);
+        casesensitive = atoi(fields[4]);
+        count = atoi(fields[5]);
+        if (searchtype < SEARCH_REGEX ||
+            searchtype > SEARCH_SUBSTRING ||
+            (casesensitive != 0 && casesensitive != 1) ||
+            count < 0)
+          { error = 1; }
+      }
+
+    if (!error)
+      {   /* the remaining fields are the search data */
+        for (i = 0; i < count && !error; i++)
+          {
+            field = strlen(ptr);
+            if (ptr + field >= buffer + size)
+              { error = 1; }
+            else
+              {
+                config -> searchdata = listAdd(config -> searchdata, ptr);
+                ptr += field + 1;
+              }
+          }
+      }
+
+    if (!error)
+      {
+        runtime -> searchtype = searchtype;
+        runtime -> casesensitive = casesensitive;
+
+        /* the search writes to the stdout and stderr of the client */
+        fflush(stdout);
+        fflush(stderr);
+        savedout = dup(STDOUT_FILENO);
+        savederr = dup(STDERR_FILENO);
+        dup2(fds[0], STDOUT_FILENO);
+        dup2(fds[1], STDERR_FILENO);
+
+        result = cliSearch();
+
+        fflush(stdout);
+        fflush(stderr);
+        dup2(savedout, STDOUT_FILENO);
+        dup2(savederr, STDERR_FILENO);
+        close(savedout);
+        close(savederr);
+
+        status = (result) ? AGENT_ERROR : AGENT_OK;
+      }
+
+    config -> searchdata = listFree(config -> searchdata);
+    memFree(__FILE__, __LINE__, buffer, AGENT_BUFFERSIZE);
+    for (i = 0; i < 2; i++)
+      {
+        if (fds[i] != -1)
+          { close(fds[i]); }
+      }
+
+    while (write(fd, &status, 1) == -1 &&
+        errno == EINTR)
+      { }
+
+    return quit;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    keep the loaded database and answer the searches of other
+ *                CLI calls of the same user; the agent quits when it was idle
+ *                for AgentTimeout seconds or the database file changes
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         int 0 if all is ok, 1 on error
+ */
+int agentServe(void)
+  {
+    struct sockaddr_un  address;
+    struct timeval      timeout;
+    fd_set              readset;
+    int                 fd,
+                        client,
+                        result;
+
+    TRACE(99, "agentServe()", NULL);
+
+    if (agentFilePath(runtime -> dbfile, agentdbfile) ||
+        stat(agentdbfile, &agentdbstat))
+      {
+        fprintf(stderr, _("error: %s\n"),
+            _("the agent can not find the database file."));
+        return 1;
+      }
+    agentFilePath(config -> rcfile, agentrcfile);
+
+    /* the search data comes with each request */
+    config -> searchdata = listFree(config -> searchdata);
+
+    /* a socket which nobody answers is left over from an earlier agent */
+    while (!agentSocketPath(&address, 0))
+      {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1)
+          {
+            fprintf(stderr, _("error: %s\n"), strerror(errno));
+            return 1;
+          }
+
+        if (!connect(fd, (struct sockaddr*)&address, sizeof(address)))
+          {
+            close(fd);
+            fprintf(stderr, _("error: %s\n"),
+                _("an agent is already running."));
+            return 1;
+          }
+        close(fd);
+        if (agentSocketRemove(&address))
+          {
+            fprintf(stderr, _("error: %s\n"), strerror(errno));
+            return 1;
+          }
+      }
+
+    if (agentSocketPath(&address, 1))
+      {
+        fprintf(stderr, _("error: %s\n"),
+            _("the agent can not use its socket directory."));
+        return 1;
+      }
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1 ||
+        bind(fd, (struct sockaddr*)&address, sizeof(address)) ||
+        chmod(address.sun_path, S_IRUSR | S_IWUSR) ||
+        listen(fd, 16))
+      {
+        fprintf(stderr, _("error: %s\n"), strerror(errno));
+        if (fd != -1)
+          { close(fd); }
+        agentSocketRemove(&address);
+        return 1;
+      }
+
+    /* a client which goes away must not take us with it */
+    signal(SIGPIPE, SIG_IGN);
+
+    fprintf(stderr, _("agent for %s listening on %s\n"),
+        agentdbfile, address.sun_path);
+
+    while (1)
+      {
+        FD_ZERO(&readset);
+        FD_SET(fd, &readset);
+        timeout.tv_sec = config -> agenttimeout;
+        timeout.tv_usec = 0;
+
+        result = select(fd + 1, &readset, NULL, NULL,
+            (config -> agenttimeout) ? &timeout : NULL);
+        if (result == -1 &&
+            errno == EINTR)
+          { continue; }
+        if (result <= 0)
+          {   /* we were idle long enough */
+            break;
+          }
+
+        client = accept(fd, NULL, NULL);
+        if (client == -1)
+          { continue; }
+
+        result = agentRequest(client);
+        close(client);
+
+        if (result)
+          {
+            fprintf(stderr, _("the database changed, the agent quits.\n"));
+            break;
+          }
+      }
+
+    close(fd);
+    agentSocketRemove(&address);
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    check that a directory for the socket is no link, belongs
+ *                to the user and that nobody else may access it
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      const char* directory - the directory to check
+ * Return         int 1 if the directory can't be used, otherwise 0
+ */
+int agentSocketDirectory(const char* directory)
+  {
+    struct stat         filestat;
+
+    TRACE(99, "agentSocketDirectory()", NULL);
+
+    if (lstat(directory, &filestat) ||
+        !S_ISDIR(filestat.st_mode) ||
+        filestat.st_uid != getuid() ||
+        (filestat.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO)) != S_IRWXU)
+      { return 1; }
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    get the socket address of the agent; the socket lives in
+ *                $XDG_RUNTIME_DIR or, without it, in a directory with a
+ *                random name in AGENT_TMPDIR which only the user may
+ *                access; the agent creates such a directory, the clients
+ *                look for one which holds a socket
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      struct sockaddr_un* address - address to fill
+ *                int create                  - 1 if the directory may be
+ *                                              created
+ * Return         int 1 if there is no usable directory, otherwise 0
+ */
+int agentSocketPath(struct sockaddr_un* address, int create)
+  {
+    struct stat         filestat;
+    struct dirent*      entry;
+    DIR*                dir;
+    /* Flawfinder: ignore */
+    char                directory[sizeof(address -> sun_path)];
+    /* Flawfinder: ignore */
+    char                prefix[64];
+    char*               runtimedir;
+    int                 found = 0,
+                        length;
+
+    TRACE(99, "agentSocketPath()", NULL);
+
+    memset(address, 0, sizeof(struct sockaddr_un));
+    address -> sun_family = AF_UNIX;
+
+    /* Flawfinder: ignore */
+    runtimedir = getenv("XDG_RUNTIME_DIR");
+    if (runtimedir &&
+        runtimedir[0] == '/')
+      {   /* the runtime directory already is private to the user */
+        length = snprintf(address -> sun_path, sizeof(address -> sun_path),
+            "%s/cpm-agent", runtimedir);
+        if (length >= (int)sizeof(address -> sun_path) ||
+            agentSocketDirectory(runtimedir))
+          { return 1; }
+
+        /* the clients only use a socket which exists */
+        if (!create &&
+            (lstat(address -> sun_path, &filestat) ||
+             !S_ISSOCK(filestat.st_mode)))
+          { return 1; }
+
+        return 0;
+      }
+
+    length = snprintf(prefix, 64, "cpm-%ld-", (long)getuid());
+    if (create)
+      {
+        snprintf(directory, sizeof(directory), "%s/%sXXXXXX",
+            AGENT_TMPDIR, prefix);
+        if (!mkdtemp(directory))
+          { return 1; }
+        found = 1;
+      }
+    else
+      {   /* we look for the directory of a running agent */
+        dir = opendir(AGENT_TMPDIR);
+        if (!dir)
+          { return 1; }
+
+        while (!found &&
+            (entry = readdir(dir)))
+          {
+            if (strncmp(entry -> d_name, prefix, length) ||
+                strlen(entry -> d_name) != (size_t)length + 6)
+              { continue; }
+
+            snprintf(directory, sizeof(directory), "%s/%s",
+                AGENT_TMPDIR, entry -> d_name);
+            snprintf(address -> sun_path, sizeof(address -> sun_path),
+                "%s/agent", directory);
+            if (!lstat(address -> sun_path, &filestat) &&
+                S_ISSOCK(filestat.st_mode) &&
+                !agentSocketDirectory(directory))
+              { found = 1; }
+          }
+        closedir(dir);
+      }
+
+    /* we don't follow any links and nobody else may use the directory */
+    if (!found ||
+        agentSocketDirectory(directory))
+      { return 1; }
+
+    snprintf(address -> sun_path, sizeof(address -> sun_path), "%s/agent",
+        directory);
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    remove the socket of the agent and the directory it was
+ *                created in; $XDG_RUNTIME_DIR itself is kept
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      struct sockaddr_un* address - address of the socket
+ * Return         int 1 if the socket can't be removed, otherwise 0
+ */
+int agentSocketRemove(struct sockaddr_un* address)
+  {
+    /* Flawfinder: ignore */
+    char                prefix[64];
+    char*               slash;
+
+    TRACE(99, "agentSocketRemove()", NULL);
+
+    if (unlink(address -> sun_path) &&
+        errno != ENOENT)
+      { return 1; }
+
+    snprintf(prefix, 64, "%s/cpm-%ld-", AGENT_TMPDIR, (long)getuid());
+    if (strncmp(address -> sun_path, prefix, strlen(prefix)))
+      { return 0; }
+
+    slash = strrchr(address -> sun_path, '/');
+    *slash = 0;
+    rmdir(address -> sun_path);
+    *slash = '/';
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ */
+
@@ -143,11 +143,17 @@ void initConfiguration(void)
 #ifdef TEST_OPTION
     config -> testrun = NULL;
 #endif
+    config -> batchdelimiter = '\n';
     config -> hidecharacter = '*';
 
+    config -> agent = 0;
     config -> asktoquit = 0;
+    config -> batch = 0;
+    config -> binaryoutput = 0;
     config -> casesensitive = 1;
     config -> compression = Z_BEST_COMPRESSION;
+    config -> compressionthreads = 1;
+    config -> compressiontype = COMPRESSION_GZIP;
     config -> configtest = 0;
     config -> cracklibstatus = CRACKLIB_ON;
     config -> createbackup = 1;
@@ -159,10 +165,13 @@ void initConfiguration(void)
     config -> keeppassphrase = 0;
     config -> passwordlength = 10;
     config -> readonly = 0;
+    config -> regexengine = REGEX_POSIX;
     config -> searchtype = SEARCH_REGULAR;
+    config -> searchthreads = 0;
     config -> security = 0;
     config -> templatelock = 0;
     config -> version = 0;
+    config -> agenttimeout = 900;
     config -> inactivetimeout = 0;
 
     runtime -> memlock_limit = -2;
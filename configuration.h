@@ -49,11 +49,17 @@ typedef struct
 #ifdef TEST_OPTION
     char*               testrun;
 #endif
+    char                batchdelimiter;
     char                hidecharacter;
 
+    int                 agent;
     int                 asktoquit;
+    int                 batch;
+    int                 binaryoutput;
     int                 casesensitive;
     int                 compression;
+    int                 compressionthreads;
+    int                 compressiontype;
     int                 configtest;
     int                 cracklibstatus;
     int                 createbackup;
@@ -65,10 +71,13 @@ typedef struct
     int                 keeppassphrase;
     int                 passwordlength;
     int                 readonly;
+    int                 regexengine;
+    int                 searchthreads;
     int                 searchtype;
     int                 security;
     int                 templatelock;
     int                 version;
+    unsigned int        agenttimeout;
     unsigned int        inactivetimeout;
   } cpmconfig_t;
 
@@ -104,12 +113,20 @@ typedef struct
 cpmconfig_t*            config;
 cpmruntime_t*           runtime;
 
+#define COMPRESSION_GZIP  0
+#define COMPRESSION_ZSTD  1
+
 #define CRACKLIB_OFF    0
 #define CRACKLIB_ON     1
 
-#define SEARCH_UNDEF    0
-#define SEARCH_REGEX    1
-#define SEARCH_REGULAR  2
+#define REGEX_POSIX     0
+#define REGEX_BUILTIN   1
+
+#define SEARCH_UNDEF      0
+#define SEARCH_REGEX      1
+#define SEARCH_REGULAR    2
+#define SEARCH_PREFIX     3
+#define SEARCH_SUBSTRING  4
 
 #endif
 
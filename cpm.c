@@ -58,6 +58,9 @@ RETSIGTYPE sighandler(int signum);
 #ifdef MANUAL_EXTERN_ENVIRON
 char**                  environ;
 #endif
+#ifdef TEST_OPTION
+  #define MEMSET_TESTSIZE   (16 + 512 + 16)
+#endif
 
 static struct termios tcsaved;
 void savetermios(void)
@@ -210,6 +213,13 @@ int main(int argc, char **argv, char **envp)
         testEnvironment();
         testrun = 1;
       }
+    if (!error &&
+        config -> testrun &&
+        !strcmp(config -> testrun, "memset"))
+      {
+        testMemset();
+        testrun = 1;
+      }
     if (!error &&
         config -> testrun && (
         !strcmp(config -> testrun, "backup") ||
@@ -352,6 +362,50 @@ RETSIGTYPE sighandler(int signum){
 }
 
 
+#ifdef TEST_OPTION
 /* #############################################################################
+ *
+ * Description    test the memSet() function; first we make sure that every
+ *                byte of the given range is wiped and nothing around it is
+ *                touched for all alignments and a range of small sizes
+ * Author         Harry Brueckner
+ * Date           2005-05-17
+ * Arguments      void
+ * Return         void
  */
+void testMemset(void)
+  {
+    size_t              i,
+                        offset,
+                        size;
+    int                 clean = 1;
+    unsigned char*      buffer;
+
+    TRACE(99, "testMemset()", NULL);
+
+    buffer = memAlloc(__FILE__, __LINE__, MEMSET_TESTSIZE);
 
+    for (offset = 0; offset < 16; offset++)
+      {
+        for (size = 0; size < 512; size++)
+          {
+            memset(buffer, 0xa5, offset + size + 16);
+            memSet(buffer + offset, 0, size);
+
+            for (i = 0; i < offset + size + 16; i++)
+              {
+                if (buffer[i] != (i >= offset && i < offset + size ? 0 : 0xa5))
+                  { clean = 0; }
+              }
+          }
+      }
+
+    printf("memSet %s\n", (clean) ? "clean" : "dirty");
+
+    memFree(__FILE__, __LINE__, buffer, MEMSET_TESTSIZE);
+  }
+#endif
+
+
+/* #############################################################################
+ */
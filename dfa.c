@@ -0,0 +1,1300 @@
+/* #############################################################################
+ * code for the builtin regular expression engine
+ * #############################################################################
+ * Copyright (C) 2005-2009 Harry Brueckner
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or any later version.
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contact: Harry Brueckner <harry_b@mm.st>
+ *          Muenchener Strasse 12a
+ *          85253 Kleinberghofen
+ *          Germany
+ * #############################################################################
+ *
+ * An extended regular expression is compiled into a Thompson NFA once per
+ * search. Every thread runs it through a DFA cache of its own, whose states
+ * are the sets of NFA nodes and which are only created when a byte leads into
+ * them for the first time, so after a few nodes of the tree every byte of a
+ * search string costs a single table lookup.
+ *
+ * Only the expressions which behave the same as with regcomp() are compiled;
+ * for anything else dfaCompile() returns NULL and the caller must use
+ * regcomp() instead. This includes intervals, backslash sequences of GNU,
+ * equivalence classes and collating elements, ranges which depend on the
+ * collation, empty expressions and syntax errors, so regcomp() reports them.
+ */
+
+/* #############################################################################
+ * includes
+ */
+#include "cpm.h"
+#include <ctype.h>
+#include <langinfo.h>
+#include "dfa.h"
+#include "general.h"
+#include "memory.h"
+
+
+/* #############################################################################
+ * global variables
+ */
+#define DFA_NODE_EPSILON  0
+#define DFA_NODE_SPLIT    1
+#define DFA_NODE_SET      2
+#define DFA_NODE_BOL      3
+#define DFA_NODE_EOL      4
+#define DFA_NODE_MATCH    5
+
+#define DFA_SETSIZE       32      /* bytes of the bitmap of a byte set */
+#define DFA_HASHSIZE      1024
+#define DFA_MAXSTATES     1000    /* the cache is cleared above this size */
+#define DFA_SEARCHSTATES  4000    /* a single search gives up at this size */
+
+typedef struct sDfaNode DFANODE;
+struct sDfaNode
+  {
+    int                 type;
+    int                 out,
+                        out1;
+    int                 set;
+  };
+
+typedef struct sDfaFragment DFAFRAGMENT;
+struct sDfaFragment
+  {
+    int                 start,
+                        end;      /* the node whose out is still open */
+  };
+
+typedef struct sDfaParser DFAPARSER;
+struct sDfaParser
+  {
+    DFA*                dfa;
+    const unsigned char* ptr;
+    int                 casesensitive,
+                        utf8;
+  };
+
+struct sDfa
+  {
+    DFANODE*            node;
+    unsigned char*      set;
+    int                 nodes,
+                        nodesize,
+                        sets,
+                        setsize,
+                        start;
+  };
+
+typedef struct sDfaState DFASTATE;
+struct sDfaState
+  {
+    int*                node;     /* the sorted NFA nodes of the state */
+    int                 nodes,
+                        chain;    /* next state of the same hash bucket */
+    unsigned int        hash;
+    char                accept,   /* a match was found */
+                        acceptend,  /* a match if the string ends here */
+                        atstart;
+  };
+
+struct sDfaCache
+  {
+    DFA*                dfa;
+    DFASTATE**          state;
+    int*                next;     /* 256 transitions per state */
+    int*                bucket;
+    int*                list;
+    int*                stack;
+    unsigned int*       mark;
+    unsigned int        generation;
+    int                 listsize,
+                        overflow, /* a search needed too many states */
+                        size,
+                        start,
+                        states;
+  };
+
+typedef struct sDfaClass DFACLASS;
+struct sDfaClass
+  {
+    const char*         name;
+    int                 (*check) (int c);
+  };
+
+static const DFACLASS   dfaclass[] =
+  {
+    { "alnum",  isalnum },
+    { "alpha",  isalpha },
+    { "blank",  isblank },
+    { "cntrl",  iscntrl },
+    { "digit",  isdigit },
+    { "graph",  isgraph },
+    { "lower",  islower },
+    { "print",  isprint },
+    { "punct",  ispunct },
+    { "space",  isspace },
+    { "upper",  isupper },
+    { "xdigit", isxdigit },
+    { NULL,     NULL }
+  };
+
+
+/* #############################################################################
+ * internal functions
+ */
+void dfaAlternate(DFA* dfa, DFAFRAGMENT* fragment, DFAFRAGMENT* right);
+void dfaCacheClear(DFACACHE* cache);
+void dfaClosure(DFACACHE* cache, int node, int atstart, int atend);
+void dfaClosureBegin(DFACACHE* cache);
+int dfaCompare(const void* a, const void* b);
+void dfaConcatenate(DFA* dfa, DFAFRAGMENT* fragment, DFAFRAGMENT* right);
+void dfaFold(DFAPARSER* parser, unsigned char* bytes);
+void dfaFragmentMultibyte(DFA* dfa, DFAFRAGMENT* fragment);
+void dfaFragmentSet(DFA* dfa, DFAFRAGMENT* fragment,
+    const unsigned char* bytes);
+int dfaNodeAdd(DFA* dfa, int type, int out, int out1, int set);
+int dfaParseAlternation(DFAPARSER* parser, DFAFRAGMENT* fragment);
+int dfaParseAtom(DFAPARSER* parser, DFAFRAGMENT* fragment);
+int dfaParseBracket(DFAPARSER* parser, DFAFRAGMENT* fragment);
+int dfaParseConcatenation(DFAPARSER* parser, DFAFRAGMENT* fragment);
+int dfaParseRepetition(DFAPARSER* parser, DFAFRAGMENT* fragment);
+int dfaRangeValid(int first, int last);
+int dfaStateGet(DFACACHE* cache, int atstart);
+int dfaTransition(DFACACHE* cache, int id, int c);
+
+
+/* #############################################################################
+ *
+ * Description    join two fragments as alternatives
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFA* dfa                - the expression
+ *                DFAFRAGMENT* fragment   - the first alternative which
+ *                                          returns the joined fragment
+ *                DFAFRAGMENT* right      - the second alternative
+ * Return         void
+ */
+void dfaAlternate(DFA* dfa, DFAFRAGMENT* fragment, DFAFRAGMENT* right)
+  {
+    int                 end,
+                        split;
+
+    end = dfaNodeAdd(dfa, DFA_NODE_EPSILON, -1, -1, -1);
+    split = dfaNodeAdd(dfa, DFA_NODE_SPLIT, fragment -> start, right -> start,
+        -1);
+    dfa -> node[fragment -> end].out = end;
+    dfa -> node[right -> end].out = end;
+
+    fragment -> start = split;
+    fragment -> end = end;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    create a DFA cache for the given expression; a cache must
+ *                only be used by one thread at a time
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFA* dfa  - the compiled expression
+ * Return         DFACACHE* the new cache
+ */
+DFACACHE* dfaCacheCreate(DFA* dfa)
+  {
+    DFACACHE*           cache;
+    int                 i;
+
+    TRACE(99, "dfaCacheCreate()", NULL);
+
+    cache = memAlloc(__FILE__, __LINE__, sizeof(DFACACHE));
+    cache -> dfa = dfa;
+    cache -> state = NULL;
+    cache -> next = NULL;
+    cache -> bucket = memAlloc(__FILE__, __LINE__, DFA_HASHSIZE * sizeof(int));
+    cache -> list = memAlloc(__FILE__, __LINE__, dfa -> nodes * sizeof(int));
+    cache -> stack = memAlloc(__FILE__, __LINE__,
+        (2 * dfa -> nodes + 1) * sizeof(int));
+    cache -> mark = memAlloc(__FILE__, __LINE__,
+        dfa -> nodes * sizeof(unsigned int));
+    cache -> generation = 0;
+    cache -> listsize = 0;
+    cache -> overflow = 0;
+    cache -> size = 0;
+    cache -> start = -1;
+    cache -> states = 0;
+
+    for (i = 0; i < DFA_HASHSIZE; i++)
+      { cache -> bucket[i] = -1; }
+    memset(cache -> mark, 0, dfa -> nodes * sizeof(unsigned int));
+
+    return cache;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    free a DFA cache
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFACACHE* cache - the cache to free
+ * Return         void
+ */
+void dfaCacheFree(DFACACHE* cache)
+  {
+    DFA*                dfa;
+
+    TRACE(99, "dfaCacheFree()", NULL);
+
+    if (!cache)
+      { return; }
+    dfa = cache -> dfa;
+
+    dfaCacheClear(cache);
+
+    if (cache -> state)
+      {
+        memFree(__FILE__, __LINE__, cache -> state,
+            cache -> size * sizeof(DFASTATE*));
+        memFree(__FILE__, __LINE__, cache -> next,
+            cache -> size * 256 * sizeof(int));
+      }
+    memFree(__FILE__, __LINE__, cache -> bucket, DFA_HASHSIZE * sizeof(int));
+    memFree(__FILE__, __LINE__, cache -> list, dfa -> nodes * sizeof(int));
+    memFree(__FILE__, __LINE__, cache -> stack,
+        (2 * dfa -> nodes + 1) * sizeof(int));
+    memFree(__FILE__, __LINE__, cache -> mark,
+        dfa -> nodes * sizeof(unsigned int));
+    memFree(__FILE__, __LINE__, cache, sizeof(DFACACHE));
+  }
+
+
+/* #############################################################################
+ *
+ * Description    clear the states of a cache
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFACACHE* cache - the cache to clear
+ * Return         void
+ */
+void dfaCacheClear(DFACACHE* cache)
+  {
+    DFASTATE*           state;
+    int                 i;
+
+    TRACE(99, "dfaCacheClear()", NULL);
+
+    for (i = 0; i < cache -> size && cache -> state && cache -> state[i]; i++)
+      {
+        state = cache -> state[i];
+        memFree(__FILE__, __LINE__, state -> node,
+            max(1, state -> nodes) * sizeof(int));
+        memFree(__FILE__, __LINE__, state, sizeof(DFASTATE));
+        cache -> state[i] = NULL;
+      }
+    for (i = 0; i < cache -> size * 256; i++)
+      { cache -> next[i] = -1; }
+    for (i = 0; i < DFA_HASHSIZE; i++)
+      { cache -> bucket[i] = -1; }
+
+    cache -> overflow = 0;
+    cache -> start = -1;
+    cache -> states = 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    clear the states of a cache if there are too many of them
+ *                or the last search gave up; this invalidates all states
+ *                returned so far, so it must only be called between two
+ *                searches
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFACACHE* cache - the cache to trim
+ * Return         void
+ */
+void dfaCacheTrim(DFACACHE* cache)
+  {
+    TRACE(99, "dfaCacheTrim()", NULL);
+
+    if (cache -> overflow ||
+        cache -> states > DFA_MAXSTATES)
+      { dfaCacheClear(cache); }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    find out if a search gave up because the expression needed
+ *                more than DFA_SEARCHSTATES states; the results of dfaFeed()
+ *                and dfaFinish() are meaningless then and the string must be
+ *                searched in another way
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFACACHE* cache - the cache of the thread
+ * Return         int 1 if the search gave up, otherwise 0
+ */
+int dfaCacheOverflow(DFACACHE* cache)
+  {
+    TRACE(199, "dfaCacheOverflow()", NULL);
+
+    return cache -> overflow;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    add the epsilon closure of a node to the list of the cache;
+ *                the assertions are only passed at the start or the end of
+ *                the string, an end assertion which can't be passed yet is
+ *                kept in the list
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFACACHE* cache - the cache
+ *                int node        - the node to start with
+ *                int atstart     - 1 at the start of the string
+ *                int atend       - 1 at the end of the string
+ * Return         void
+ */
+void dfaClosure(DFACACHE* cache, int node, int atstart, int atend)
+  {
+    DFANODE*            nfa = cache -> dfa -> node;
+    int                 sp = 0;
+
+    cache -> stack[sp++] = node;
+    while (sp)
+      {
+        node = cache -> stack[--sp];
+        if (node < 0 ||
+            cache -> mark[node] == cache -> generation)
+          { continue; }
+        cache -> mark[node] = cache -> generation;
+
+        switch (nfa[node].type)
+          {
+            case DFA_NODE_EPSILON:
+                cache -> stack[sp++] = nfa[node].out;
+                break;
+            case DFA_NODE_SPLIT:
+                cache -> stack[sp++] = nfa[node].out1;
+                cache -> stack[sp++] = nfa[node].out;
+                break;
+            case DFA_NODE_BOL:
+                if (atstart)
+                  { cache -> stack[sp++] = nfa[node].out; }
+                break;
+            case DFA_NODE_EOL:
+                if (atend)
+                  { cache -> stack[sp++] = nfa[node].out; }
+                else
+                  { cache -> list[cache -> listsize++] = node; }
+                break;
+            default:
+                cache -> list[cache -> listsize++] = node;
+                break;
+          }
+      }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    start a new list of NFA nodes in the cache
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFACACHE* cache - the cache
+ * Return         void
+ */
+void dfaClosureBegin(DFACACHE* cache)
+  {
+    cache -> listsize = 0;
+    if (!++cache -> generation)
+      {   /* the marks of the old generations must not match again */
+        memset(cache -> mark, 0, cache -> dfa -> nodes * sizeof(unsigned int));
+        cache -> generation = 1;
+      }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    compare two node ids for qsort()
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      const void* a   - first id
+ *                const void* b   - second id
+ * Return         int <0, 0 or >0 like strcmp()
+ */
+int dfaCompare(const void* a, const void* b)
+  {
+    return *(const int*)a - *(const int*)b;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    compile an extended regular expression; the result can be
+ *                shared by all threads
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      const char* expression  - the expression
+ *                int casesensitive       - 0 to ignore the case
+ * Return         DFA* the compiled expression or NULL if it must be
+ *                compiled with regcomp()
+ */
+DFA* dfaCompile(const char* expression, int casesensitive)
+  {
+    DFA*                dfa;
+    DFAFRAGMENT         fragment;
+    DFAPARSER           parser;
+    int                 match;
+
+    TRACE(99, "dfaCompile()", NULL);
+
+    /* besides the single byte encodings we only know UTF-8 */
+    if (MB_CUR_MAX > 1 &&
+        strcmp(nl_langinfo(CODESET), "UTF-8"))
+      { return NULL; }
+
+    dfa = memAlloc(__FILE__, __LINE__, sizeof(DFA));
+    dfa -> node = NULL;
+    dfa -> set = NULL;
+    dfa -> nodes = 0;
+    dfa -> nodesize = 0;
+    dfa -> sets = 0;
+    dfa -> setsize = 0;
+    dfa -> start = -1;
+
+    parser.dfa = dfa;
+    parser.ptr = (const unsigned char*)expression;
+    parser.casesensitive = casesensitive;
+    parser.utf8 = (MB_CUR_MAX > 1);
+
+    if (dfaParseAlternation(&parser, &fragment) ||
+        *parser.ptr)
+      {
+        dfaFree(dfa);
+        return NULL;
+      }
+
+    match = dfaNodeAdd(dfa, DFA_NODE_MATCH, -1, -1, -1);
+    dfa -> node[fragment.end].out = match;
+    dfa -> start = fragment.start;
+
+    return dfa;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    join two fragments one after the other
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFA* dfa                - the expression
+ *                DFAFRAGMENT* fragment   - the first fragment which returns
+ *                                          the joined fragment
+ *                DFAFRAGMENT* right      - the second fragment
+ * Return         void
+ */
+void dfaConcatenate(DFA* dfa, DFAFRAGMENT* fragment, DFAFRAGMENT* right)
+  {
+    dfa -> node[fragment -> end].out = right -> start;
+    fragment -> end = right -> end;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    run a string through the DFA; the string may be given in
+ *                several parts, each of which continues with the state the
+ *                previous part returned; a transition into a state which
+ *                can't change the result anymore is stored negative, so
+ *                only a single lookup is needed for every other byte; the
+ *                search gives up once the cache holds DFA_SEARCHSTATES
+ *                states, see dfaCacheOverflow()
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFACACHE* cache     - the cache of the thread
+ *                int state           - state to start with
+ *                const char* string  - the string
+ *                int size            - length of the string
+ * Return         int the state after the string
+ */
+int dfaFeed(DFACACHE* cache, int state, const char* string, int size)
+  {
+    DFASTATE*           current = cache -> state[state];
+    const unsigned char* ptr = (const unsigned char*)string;
+    const unsigned char* end = ptr + size;
+    int                 next;
+
+    TRACE(199, "dfaFeed()", NULL);
+
+    if (current -> accept ||
+        !current -> nodes)
+      { return state; }
+
+    while (ptr < end)
+      {
+        next = cache -> next[state * 256 + *ptr];
+        if (next == -1 &&
+            cache -> states >= DFA_SEARCHSTATES)
+          {   /* the cache only grows during a search, so we give up */
+            cache -> overflow = 1;
+            return state;
+          }
+        if (next < 0)
+          {
+            next = (next == -1) ?
+                dfaTransition(cache, state, *ptr) : -2 - next;
+
+            current = cache -> state[next];
+            if (current -> accept ||
+                !current -> nodes)
+              {   /* nothing can change the result anymore */
+                return next;
+              }
+          }
+
+        state = next;
+        ptr++;
+      }
+
+    return state;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    find out if the string which led to the given state matches
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFACACHE* cache - the cache of the thread
+ *                int state       - the state after the whole string
+ * Return         int 1 if the string matches, otherwise 0
+ */
+int dfaFinish(DFACACHE* cache, int state)
+  {
+    TRACE(199, "dfaFinish()", NULL);
+
+    return (cache -> state[state] -> accept ||
+        cache -> state[state] -> acceptend);
+  }
+
+
+/* #############################################################################
+ *
+ * Description    add the cases of all characters to a byte set
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFAPARSER* parser     - the parser
+ *                unsigned char* bytes  - flag for every byte of the set
+ * Return         void
+ */
+void dfaFold(DFAPARSER* parser, unsigned char* bytes)
+  {
+    int                 c;
+
+    if (parser -> casesensitive)
+      { return; }
+
+    for (c = 1; c < ((parser -> utf8) ? 0x80 : 0x100); c++)
+      {
+        if (bytes[c])
+          {
+            bytes[tolower(c)] = 1;
+            bytes[toupper(c)] = 1;
+          }
+      }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    create a fragment which matches one UTF-8 sequence of more
+ *                than one byte
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFA* dfa                - the expression
+ *                DFAFRAGMENT* fragment   - returns the fragment
+ * Return         void
+ */
+void dfaFragmentMultibyte(DFA* dfa, DFAFRAGMENT* fragment)
+  {
+    DFAFRAGMENT         next,
+                        sequence;
+    unsigned char       continuation[256],
+                        lead[256];
+    static const int    range[3][2] = {
+                            { 0xc2, 0xdf },
+                            { 0xe0, 0xef },
+                            { 0xf0, 0xf4 } };
+    int                 c,
+                        i,
+                        length;
+
+    memset(continuation, 0, sizeof(continuation));
+    for (c = 0x80; c <= 0xbf; c++)
+      { continuation[c] = 1; }
+
+    for (i = 0; i < 3; i++)
+      {
+        memset(lead, 0, sizeof(lead));
+        for (c = range[i][0]; c <= range[i][1]; c++)
+          { lead[c] = 1; }
+
+        dfaFragmentSet(dfa, &sequence, lead);
+        for (length = 0; length <= i; length++)
+          {
+            dfaFragmentSet(dfa, &next, continuation);
+            dfaConcatenate(dfa, &sequence, &next);
+          }
+
+        if (i)
+          { dfaAlternate(dfa, fragment, &sequence); }
+        else
+          { *fragment = sequence; }
+      }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    create a fragment which matches one byte of a set
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFA* dfa                    - the expression
+ *                DFAFRAGMENT* fragment       - returns the fragment
+ *                const unsigned char* bytes  - flag for every byte of the set
+ * Return         void
+ */
+void dfaFragmentSet(DFA* dfa, DFAFRAGMENT* fragment,
+    const unsigned char* bytes)
+  {
+    unsigned char*      set;
+    int                 c,
+                        size;
+
+    if (dfa -> sets == dfa -> setsize)
+      {
+        size = max(16, dfa -> setsize * 2);
+        dfa -> set = memRealloc(__FILE__, __LINE__, dfa -> set,
+            dfa -> setsize * DFA_SETSIZE, size * DFA_SETSIZE);
+        dfa -> setsize = size;
+      }
+
+    set = dfa -> set + dfa -> sets * DFA_SETSIZE;
+    memset(set, 0, DFA_SETSIZE);
+    for (c = 1; c < 256; c++)
+      {
+        if (bytes[c])
+          { set[c >> 3] |= 1 << (c & 7); }
+      }
+
+    fragment -> start = fragment -> end = dfaNodeAdd(dfa, DFA_NODE_SET, -1, -1,
+        dfa -> sets++);
+  }
+
+
+/* #############################################################################
+ *
+ * Description    free a compiled expression
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFA* dfa  - the expression
+ * Return         void
+ */
+void dfaFree(DFA* dfa)
+  {
+    TRACE(99, "dfaFree()", NULL);
+
+    if (!dfa)
+      { return; }
+
+    if (dfa -> node)
+      {
+        memFree(__FILE__, __LINE__, dfa -> node,
+            dfa -> nodesize * sizeof(DFANODE));
+      }
+    if (dfa -> set)
+      {
+        memFree(__FILE__, __LINE__, dfa -> set,
+            dfa -> setsize * DFA_SETSIZE);
+      }
+    memFree(__FILE__, __LINE__, dfa, sizeof(DFA));
+  }
+
+
+/* #############################################################################
+ *
+ * Description    find out if a string matches the expression; the result
+ *                is meaningless if dfaCacheOverflow() reports afterwards
+ *                that the search gave up
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFACACHE* cache     - the cache of the thread
+ *                const char* string  - the string to search in
+ * Return         int 1 if the string matches, otherwise 0
+ */
+int dfaMatch(DFACACHE* cache, const char* string)
+  {
+    TRACE(199, "dfaMatch()", NULL);
+
+    return dfaFinish(cache,
+        dfaFeed(cache, dfaStart(cache), string, strlen(string)));
+  }
+
+
+/* #############################################################################
+ *
+ * Description    add a node to the NFA
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFA* dfa  - the expression
+ *                int type  - type of the node
+ *                int out   - the next node
+ *                int out1  - the alternative next node of a split
+ *                int set   - the byte set of a set node
+ * Return         int id of the node
+ */
+int dfaNodeAdd(DFA* dfa, int type, int out, int out1, int set)
+  {
+    int                 size;
+
+    if (dfa -> nodes == dfa -> nodesize)
+      {
+        size = max(64, dfa -> nodesize * 2);
+        dfa -> node = memRealloc(__FILE__, __LINE__, dfa -> node,
+            dfa -> nodesize * sizeof(DFANODE), size * sizeof(DFANODE));
+        dfa -> nodesize = size;
+      }
+
+    dfa -> node[dfa -> nodes].type = type;
+    dfa -> node[dfa -> nodes].out = out;
+    dfa -> node[dfa -> nodes].out1 = out1;
+    dfa -> node[dfa -> nodes].set = set;
+
+    return dfa -> nodes++;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    parse alternatives separated by '|'
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFAPARSER* parser       - the parser
+ *                DFAFRAGMENT* fragment   - returns the fragment
+ * Return         int 1 if the expression is left to regcomp(), otherwise 0
+ */
+int dfaParseAlternation(DFAPARSER* parser, DFAFRAGMENT* fragment)
+  {
+    DFAFRAGMENT         right;
+
+    if (dfaParseConcatenation(parser, fragment))
+      { return 1; }
+
+    while (*parser -> ptr == '|')
+      {
+        parser -> ptr++;
+        if (dfaParseConcatenation(parser, &right))
+          { return 1; }
+        dfaAlternate(parser -> dfa, fragment, &right);
+      }
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    parse a single character, a bracket expression, a group or
+ *                an assertion
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFAPARSER* parser       - the parser
+ *                DFAFRAGMENT* fragment   - returns the fragment
+ * Return         int 1 if the expression is left to regcomp(), otherwise 0
+ */
+int dfaParseAtom(DFAPARSER* parser, DFAFRAGMENT* fragment)
+  {
+    DFAFRAGMENT         multibyte,
+                        next;
+    DFA*                dfa = parser -> dfa;
+    unsigned char       bytes[256];
+    int                 c = *parser -> ptr,
+                        i,
+                        length;
+
+    memset(bytes, 0, sizeof(bytes));
+
+    switch (c)
+      {
+        case '(':
+            parser -> ptr++;
+            if (dfaParseAlternation(parser, fragment) ||
+                *parser -> ptr != ')')
+              { return 1; }
+            parser -> ptr++;
+            return 0;
+        case '[':
+            parser -> ptr++;
+            return dfaParseBracket(parser, fragment);
+        case '.':
+            parser -> ptr++;
+            for (i = 1; i < ((parser -> utf8) ? 0x80 : 0x100); i++)
+              { bytes[i] = 1; }
+            dfaFragmentSet(dfa, fragment, bytes);
+            if (parser -> utf8)
+              {
+                dfaFragmentMultibyte(dfa, &multibyte);
+                dfaAlternate(dfa, fragment, &multibyte);
+              }
+            return 0;
+        case '^':
+        case '$':
+            parser -> ptr++;
+            fragment -> start = fragment -> end = dfaNodeAdd(dfa,
+                (c == '^') ? DFA_NODE_BOL : DFA_NODE_EOL, -1, -1, -1);
+            return 0;
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+            return 1;
+        case '\\':
+            c = parser -> ptr[1];
+            if (!c ||
+                c >= 0x80 ||
+                isalnum(c) ||
+                strchr("<>`'", c))
+              {   /* GNU extensions and back references */
+                return 1;
+              }
+            parser -> ptr += 2;
+            break;
+        default:
+            if (c >= 0x80 &&
+                parser -> utf8)
+              {   /* a multibyte character is a single atom */
+                if (!parser -> casesensitive)
+                  { return 1; }
+
+                if (c >= 0xc2 && c <= 0xdf)
+                  { length = 2; }
+                else if (c >= 0xe0 && c <= 0xef)
+                  { length = 3; }
+                else if (c >= 0xf0 && c <= 0xf4)
+                  { length = 4; }
+                else
+                  { return 1; }
+
+                for (i = 0; i < length; i++)
+                  {
+                    c = parser -> ptr[i];
+                    if (i &&
+                        (c < 0x80 || c > 0xbf))
+                      { return 1; }
+
+                    memset(bytes, 0, sizeof(bytes));
+                    bytes[c] = 1;
+                    if (i)
+                      {
+                        dfaFragmentSet(dfa, &next, bytes);
+                        dfaConcatenate(dfa, fragment, &next);
+                      }
+                    else
+                      { dfaFragmentSet(dfa, fragment, bytes); }
+                  }
+                parser -> ptr += length;
+                return 0;
+              }
+            parser -> ptr++;
+            break;
+      }
+
+    /* a literal character */
+    bytes[c] = 1;
+    dfaFold(parser, bytes);
+    dfaFragmentSet(dfa, fragment, bytes);
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    parse a bracket expression after the opening '['
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFAPARSER* parser       - the parser
+ *                DFAFRAGMENT* fragment   - returns the fragment
+ * Return         int 1 if the expression is left to regcomp(), otherwise 0
+ */
+int dfaParseBracket(DFAPARSER* parser, DFAFRAGMENT* fragment)
+  {
+    DFAFRAGMENT         multibyte;
+    const unsigned char* ptr = parser -> ptr;
+    const unsigned char* end;
+    unsigned char       bytes[256];
+    size_t              length;
+    int                 c,
+                        first = 1,
+                        i,
+                        last,
+                        negate = 0;
+
+    memset(bytes, 0, sizeof(bytes));
+
+    if (*ptr == '^')
+      {
+        negate = 1;
+        ptr++;
+      }
+
+    while (first ||
+        *ptr != ']')
+      {
+        first = 0;
+        c = *ptr;
+        if (!c ||
+            (c >= 0x80 && parser -> utf8))
+          { return 1; }
+
+        if (c == '[' &&
+            (ptr[1] == '=' || ptr[1] == '.'))
+          {   /* equivalence classes and collating elements */
+            return 1;
+          }
+
+        if (c == '[' &&
+            ptr[1] == ':')
+          {   /* in UTF-8 the classes contain multibyte characters */
+            if (parser -> utf8)
+              { return 1; }
+
+            end = (const unsigned char*)strstr((const char*)ptr + 2, ":]");
+            if (!end)
+              { return 1; }
+            length = end - ptr - 2;
+
+            for (i = 0; dfaclass[i].name; i++)
+              {
+                if (strlen(dfaclass[i].name) == length &&
+                    !strncmp(dfaclass[i].name, (const char*)ptr + 2, length))
+                  { break; }
+              }
+            if (!dfaclass[i].name)
+              { return 1; }
+
+            for (c = 1; c < 256; c++)
+              {
+                if (dfaclass[i].check(c))
+                  { bytes[c] = 1; }
+              }
+            ptr = end + 2;
+            continue;
+          }
+
+        ptr++;
+        last = c;
+        if (*ptr == '-' &&
+            ptr[1] &&
+            ptr[1] != ']')
+          {
+            last = ptr[1];
+            if (!dfaRangeValid(c, last))
+              { return 1; }
+            ptr += 2;
+          }
+
+        for (i = c; i <= last; i++)
+          { bytes[i] = 1; }
+      }
+    parser -> ptr = ptr + 1;
+
+    dfaFold(parser, bytes);
+    if (negate)
+      {
+        for (c = 1; c < ((parser -> utf8) ? 0x80 : 0x100); c++)
+          { bytes[c] = !bytes[c]; }
+      }
+
+    dfaFragmentSet(parser -> dfa, fragment, bytes);
+    if (negate &&
+        parser -> utf8)
+      {   /* every multibyte character is outside of the set */
+        dfaFragmentMultibyte(parser -> dfa, &multibyte);
+        dfaAlternate(parser -> dfa, fragment, &multibyte);
+      }
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    parse a sequence of atoms with their repetitions
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFAPARSER* parser       - the parser
+ *                DFAFRAGMENT* fragment   - returns the fragment
+ * Return         int 1 if the expression is left to regcomp(), otherwise 0
+ */
+int dfaParseConcatenation(DFAPARSER* parser, DFAFRAGMENT* fragment)
+  {
+    DFAFRAGMENT         next;
+    int                 parts = 0;
+
+    while (*parser -> ptr &&
+        *parser -> ptr != '|' &&
+        *parser -> ptr != ')')
+      {
+        if (dfaParseRepetition(parser, (parts) ? &next : fragment))
+          { return 1; }
+        if (parts)
+          { dfaConcatenate(parser -> dfa, fragment, &next); }
+        parts++;
+      }
+
+    /* empty expressions are left to regcomp() */
+    return !parts;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    parse an atom followed by any number of '*', '+' or '?'
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFAPARSER* parser       - the parser
+ *                DFAFRAGMENT* fragment   - returns the fragment
+ * Return         int 1 if the expression is left to regcomp(), otherwise 0
+ */
+int dfaParseRepetition(DFAPARSER* parser, DFAFRAGMENT* fragment)
+  {
+    DFA*                dfa = parser -> dfa;
+    int                 anchor,
+                        end,
+                        split;
+
+    anchor = (*parser -> ptr == '^' || *parser -> ptr == '$');
+    if (dfaParseAtom(parser, fragment))
+      { return 1; }
+
+    while (*parser -> ptr == '*' ||
+        *parser -> ptr == '+' ||
+        *parser -> ptr == '?')
+      {
+        if (anchor)
+          { return 1; }
+
+        end = dfaNodeAdd(dfa, DFA_NODE_EPSILON, -1, -1, -1);
+        split = dfaNodeAdd(dfa, DFA_NODE_SPLIT, fragment -> start, end, -1);
+        switch (*parser -> ptr)
+          {
+            case '*':
+                dfa -> node[fragment -> end].out = split;
+                fragment -> start = split;
+                break;
+            case '+':
+                dfa -> node[fragment -> end].out = split;
+                break;
+            case '?':
+                dfa -> node[fragment -> end].out = end;
+                fragment -> start = split;
+                break;
+          }
+        fragment -> end = end;
+        parser -> ptr++;
+      }
+
+    /* intervals are left to regcomp() */
+    return (*parser -> ptr == '{');
+  }
+
+
+/* #############################################################################
+ *
+ * Description    check if a range of a bracket expression is the same in
+ *                every locale, which is true for digits and for lowercase or
+ *                uppercase ASCII letters
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      int first   - first character of the range
+ *                int last    - last character of the range
+ * Return         int 1 if the range can be used, otherwise 0
+ */
+int dfaRangeValid(int first, int last)
+  {
+    if (first > last)
+      { return 0; }
+
+    return ((first >= '0' && last <= '9') ||
+        (first >= 'a' && last <= 'z') ||
+        (first >= 'A' && last <= 'Z'));
+  }
+
+
+/* #############################################################################
+ *
+ * Description    get the state for the list of NFA nodes in the cache and
+ *                create it if it doesn't exist yet
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFACACHE* cache - the cache
+ *                int atstart     - 1 for the state at the start of a string
+ * Return         int id of the state
+ */
+int dfaStateGet(DFACACHE* cache, int atstart)
+  {
+    DFANODE*            nfa = cache -> dfa -> node;
+    DFASTATE*           state;
+    unsigned int        hash = atstart;
+    int                 i,
+                        id,
+                        size;
+
+    qsort(cache -> list, cache -> listsize, sizeof(int), dfaCompare);
+    for (i = 0; i < cache -> listsize; i++)
+      { hash = hash * 31 + cache -> list[i]; }
+
+    for (id = cache -> bucket[hash % DFA_HASHSIZE]; id >= 0;
+        id = cache -> state[id] -> chain)
+      {
+        state = cache -> state[id];
+        if (state -> hash == hash &&
+            state -> atstart == atstart &&
+            state -> nodes == cache -> listsize &&
+            !memcmp(state -> node, cache -> list,
+                cache -> listsize * sizeof(int)))
+          { return id; }
+      }
+
+    if (cache -> states == cache -> size)
+      {
+        size = max(64, cache -> size * 2);
+        cache -> state = memRealloc(__FILE__, __LINE__, cache -> state,
+            cache -> size * sizeof(DFASTATE*), size * sizeof(DFASTATE*));
+        cache -> next = memRealloc(__FILE__, __LINE__, cache -> next,
+            cache -> size * 256 * sizeof(int), size * 256 * sizeof(int));
+        for (i = cache -> size; i < size; i++)
+          { cache -> state[i] = NULL; }
+        for (i = cache -> size * 256; i < size * 256; i++)
+          { cache -> next[i] = -1; }
+        cache -> size = size;
+      }
+
+    state = memAlloc(__FILE__, __LINE__, sizeof(DFASTATE));
+    state -> node = memAlloc(__FILE__, __LINE__,
+        max(1, cache -> listsize) * sizeof(int));
+    memcpy(state -> node, cache -> list, cache -> listsize * sizeof(int));
+    state -> nodes = cache -> listsize;
+    state -> hash = hash;
+    state -> atstart = atstart;
+    state -> accept = 0;
+    state -> acceptend = 0;
+
+    /* an end assertion may lead to a match once the string ends */
+    dfaClosureBegin(cache);
+    for (i = 0; i < state -> nodes; i++)
+      {
+        switch (nfa[state -> node[i]].type)
+          {
+            case DFA_NODE_MATCH:
+                state -> accept = 1;
+                break;
+            case DFA_NODE_EOL:
+                dfaClosure(cache, nfa[state -> node[i]].out, atstart, 1);
+                break;
+          }
+      }
+    for (i = 0; i < cache -> listsize; i++)
+      {
+        if (nfa[cache -> list[i]].type == DFA_NODE_MATCH)
+          { state -> acceptend = 1; }
+      }
+
+    id = cache -> states++;
+    state -> chain = cache -> bucket[hash % DFA_HASHSIZE];
+    cache -> bucket[hash % DFA_HASHSIZE] = id;
+    cache -> state[id] = state;
+
+    return id;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    get the state at the start of a string
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFACACHE* cache - the cache of the thread
+ * Return         int id of the state
+ */
+int dfaStart(DFACACHE* cache)
+  {
+    TRACE(199, "dfaStart()", NULL);
+
+    if (cache -> start < 0)
+      {
+        dfaClosureBegin(cache);
+        dfaClosure(cache, cache -> dfa -> start, 1, 0);
+        cache -> start = dfaStateGet(cache, 1);
+      }
+
+    return cache -> start;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    create the transition of a state for one byte; as the
+ *                expression may match anywhere in the string, the start of
+ *                the NFA is part of every state
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      DFACACHE* cache - the cache
+ *                int id          - the state
+ *                int c           - the byte
+ * Return         int id of the next state
+ */
+int dfaTransition(DFACACHE* cache, int id, int c)
+  {
+    DFA*                dfa = cache -> dfa;
+    DFANODE*            node;
+    DFASTATE*           state = cache -> state[id];
+    int                 i,
+                        next;
+
+    dfaClosureBegin(cache);
+    for (i = 0; i < state -> nodes; i++)
+      {
+        node = &dfa -> node[state -> node[i]];
+        if (node -> type == DFA_NODE_SET &&
+            dfa -> set[node -> set * DFA_SETSIZE + (c >> 3)] & (1 << (c & 7)))
+          { dfaClosure(cache, node -> out, 0, 0); }
+      }
+    dfaClosure(cache, dfa -> start, 0, 0);
+
+    next = dfaStateGet(cache, 0);
+    state = cache -> state[next];
+    cache -> next[id * 256 + c] = (state -> accept || !state -> nodes) ?
+        -2 - next : next;
+
+    return next;
+  }
+
+
+/* #############################################################################
+ */
+
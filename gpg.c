@@ -25,6 +25,7 @@
  * includes
  */
 #include "cpm.h"
+#include <ctype.h>
 #include "configuration.h"
 #include "general.h"
 #include "gpg.h"
@@ -38,36 +39,63 @@
 /* #############################################################################
  * internal functions
  */
+typedef struct sGpgKeyCache GPGKEYCACHE;
 #define gpgError(error)    fprintf(stderr, "GpgMe error (line %d): %s (%d)\n", \
                                 __LINE__, gpgme_strerror(error), error)
 int gpgCheckSignResult(SHOWERROR_FN showerror_cb, gpgme_sign_result_t result,
     gpgme_sig_mode_t type);
 int gpgCheckVerifyResult(SHOWERROR_FN showerror_cb,
     gpgme_verify_result_t result, gpgme_error_t status);
-char* gpgData2Char(gpgme_data_t dh, int* newsize);
 #ifdef TEST_OPTION
 void gpgDebugKey(gpgme_key_t key);
 #endif
-char* gpgGetFingerprint(char* keyname, int secret_only);
+gpgme_key_t gpgGetKey(char* keyname, int secret_only);
 char* gpgGetRealm(const char* desc);
 gpgme_error_t gpgRequestPassphrase(void *hook, const char *uid_hint,
     const char *passphrase_info, int last_was_bad, int fd);
+ssize_t gpgStreamWrite(void* handle, const void* buffer, size_t size);
 #ifdef GPGME_HAS_RECIPIENT
 int gpgGetRecipients(gpgme_recipient_t recipients,
     SHOWERROR_FN showerror_cb);
 #endif
+GPGKEYCACHE* gpgKeyCacheCreate(const char* pattern, int secret);
+void gpgKeyCacheDestroy(GPGKEYCACHE* entry);
+GPGKEYCACHE* gpgKeyCacheFind(const char* pattern, int secret);
+GPGKEYCACHE* gpgKeyCacheGet(const char* pattern, int secret);
+int gpgKeyCacheKeyId(const char* pattern);
+int gpgKeyCacheList(char** keynames, int count, int secret);
+int gpgKeyCacheMatch(const char* pattern, gpgme_key_t key);
 
 
 /* #############################################################################
  * global variables
  */
+typedef struct
+  {
+    GPGWRITE_FN         writer;
+    void*               handle;
+  } GPGSTREAM;
+
+struct gpgme_data_cbs   stream_callbacks = { NULL, gpgStreamWrite, NULL, NULL };
 PASSPHRASE_FN           passphrase_callback;
 int                     retries;
 int                     signers;
 char*                   lastrealm = NULL;
 
+/* the keys gpg listed for a key name, kept for the whole session */
+struct sGpgKeyCache
+  {
+    GPGKEYCACHE*        next;
+    gpgme_key_t*        key;
+    char*               pattern;
+    int                 keys,
+                        secret;
+  };
+GPGKEYCACHE*            keycache = NULL;
+
 #define LIST_ALL        0
 #define LIST_SECRET     1
+#define KEYID_LENGTH    16
 
 
 /* #############################################################################
@@ -87,6 +115,8 @@ void freeGPG(void)
         memFreeString(__FILE__, __LINE__, lastrealm);
         lastrealm = NULL;
       }
+
+    gpgKeyCacheFlush();
   }
 
 
@@ -391,55 +421,6 @@ int gpgCheckVerifyResult(SHOWERROR_FN showerror_cb,
   }
 
 
-/* #############################################################################
- *
- * Description    function to convert a GpgMe buffer into a char* buffer
- * Author         Harry Brueckner
- * Date           2005-04-01
- * Arguments      gpgme_data_t dh - the data handler
- *                int* newsize    - size of the returned buffer
- * Return         char* NULL on error, otherwise the encrypted data
- */
-#define BUFFERSIZE      10240
-char* gpgData2Char(gpgme_data_t dh, int* newsize)
-  {
-    size_t              tmpsize;
-    char*               newbuffer;
-    char*               tmpbuffer;
-
-    TRACE(99, "gpgData2Char()", NULL);
-
-    newbuffer = NULL;
-    *newsize = 0;
-
-    /* we have to rewind the buffer */
-    if (gpgme_data_seek(dh, 0, SEEK_SET))
-      {
-        gpgError(gpgme_err_code_from_errno(errno));
-        return NULL;
-      }
-    tmpbuffer = memAlloc(__FILE__, __LINE__, BUFFERSIZE + 1);
-    while ((tmpsize = gpgme_data_read(dh, tmpbuffer, BUFFERSIZE)) > 0)
-      {
-        newbuffer = memRealloc(__FILE__, __LINE__, newbuffer,
-            *newsize, *newsize + tmpsize);
-
-        /* Flawfinder: ignore */
-        memcpy(newbuffer + *newsize, tmpbuffer, tmpsize);
-        *newsize += tmpsize;
-      }
-    memFree(__FILE__, __LINE__, tmpbuffer, BUFFERSIZE + 1);
-    if (tmpsize < 0)
-      {
-        gpgError(gpgme_err_code_from_errno(errno));
-        return NULL;
-      }
-
-    return newbuffer;
-  }
-#undef BUFFERSIZE
-
-
 /* #############################################################################
  *
  * Description    display all given key data to stderr
@@ -559,28 +540,31 @@ void gpgDebugKey(gpgme_key_t key)
 
 /* #############################################################################
  *
- * Description    encrypt the given buffer and return the encrypted data with
- *                an updated size information
+ * Description    decrypt the given file and hand the decrypted data in chunks
+ *                to the writer callback as soon as GpgMe produces it
  * Author         Harry Brueckner
  * Date           2005-03-31
- * Arguments      char* buffer      - buffer to encrypt
- *                int size          - size of the buffer
- *                char** newbuffer  - pointer to the new buffer which holds the
- *                                    encrypted data
- *                int* newsize      - size of the returned buffer
+ * Arguments      int fd                      - file descriptor to read the
+ *                                              encrypted data from
+ *                gpgme_data_encoding_t encoding  - encoding of the data,
+ *                                              armored, binary or unknown
+ *                GPGWRITE_FN writer_cb       - callback function which
+ *                                              receives the decrypted data
+ *                void* handle                - handle passed to writer_cb
  *                PASSPHRASE_FN password_cb   - callback function pointer used
  *                                              to get the current passphrase
  *                SHOWERROR_FN showerror_cb   - callback function pointer used
  *                                              to display errors
  * Return         0 if ok, otherwise 1
  */
-int gpgDecrypt(char* buffer, int size, char** newbuffer, int* newsize,
-    PASSPHRASE_FN password_cb, SHOWERROR_FN showerror_cb)
+int gpgDecrypt(int fd, gpgme_data_encoding_t encoding, GPGWRITE_FN writer_cb,
+    void* handle, PASSPHRASE_FN password_cb, SHOWERROR_FN showerror_cb)
   {
+    GPGSTREAM           stream;
     gpgme_ctx_t         context;
     gpgme_error_t       error;
-    gpgme_data_t        input,
-                        output;
+    gpgme_data_t        input = NULL,
+                        output = NULL;
     gpgme_decrypt_result_t  decrypt_result = NULL;
     gpgme_verify_result_t   verify_result;
     int                 showerror = 1;
@@ -592,8 +576,8 @@ int gpgDecrypt(char* buffer, int size, char** newbuffer, int* newsize,
     /* we set our passphrase callback function */
     passphrase_callback = password_cb;
 
-    *newbuffer = NULL;
-    *newsize = 0;
+    stream.writer = writer_cb;
+    stream.handle = handle;
 
     error = gpgme_new(&context);
     if (error)
@@ -612,11 +596,18 @@ int gpgDecrypt(char* buffer, int size, char** newbuffer, int* newsize,
           }
       }
 
+    /* GpgMe reads the file itself and writes the plaintext through our
+     * callback, so neither the ciphertext nor the plaintext is ever held
+     * in one piece
+     */
     if (!error)
-      { error = gpgme_data_new_from_mem(&input, buffer, size, 0); }
+      { error = gpgme_data_new_from_fd(&input, fd); }
 
     if (!error)
-      { error = gpgme_data_new(&output); }
+      { error = gpgme_data_set_encoding(input, encoding); }
+
+    if (!error)
+      { error = gpgme_data_new_from_cbs(&output, &stream_callbacks, &stream); }
 
     if (!error)
       { error = gpgme_op_decrypt_verify(context, input, output); }
@@ -649,9 +640,6 @@ int gpgDecrypt(char* buffer, int size, char** newbuffer, int* newsize,
     /* we don't need the passphrase any longer */
     clearPassphrase(0);
 
-    if (!error)
-      { tmpbuffer = gpgData2Char(output, newsize); }
-
 #ifdef GPGME_HAS_RECIPIENT
     /* we get the recipients of the message for the further re-encryption of
      * the file
@@ -665,12 +653,12 @@ int gpgDecrypt(char* buffer, int size, char** newbuffer, int* newsize,
       }
 #endif
 
-    gpgme_data_release(input);
-    gpgme_data_release(output);
+    if (input)
+      { gpgme_data_release(input); }
+    if (output)
+      { gpgme_data_release(output); }
     gpgme_release(context);
 
-    *newbuffer = tmpbuffer;
-
     if (error)
       {
         if (showerror)
@@ -684,27 +672,28 @@ int gpgDecrypt(char* buffer, int size, char** newbuffer, int* newsize,
 
 /* #############################################################################
  *
- * Description    encrypt the given buffer and return the encrypted data with
- *                an updated size information
+ * Description    encrypt the given buffer and hand the encrypted data in
+ *                chunks to the writer callback as soon as GpgMe produces it
  * Author         Harry Brueckner
  * Date           2005-03-31
- * Arguments      char* buffer      - buffer to encrypt
- *                int size          - size of the buffer
- *                char** newbuffer  - pointer to the new buffer which holds the
- *                                    encrypted data
- *                int* newsize      - size of the returned buffer
+ * Arguments      char* buffer                - buffer to encrypt
+ *                int size                    - size of the buffer
+ *                GPGWRITE_FN writer_cb       - callback function which
+ *                                              receives the encrypted data
+ *                void* handle                - handle passed to writer_cb
  *                PASSPHRASE_FN password_cb   - callback function pointer used
  *                                              to get the current passphrase
  *                SHOWERROR_FN showerror_cb   - callback function pointer used
  *                                              to display errors
  * Return         0 if ok, otherwise 1
  */
-int gpgEncrypt(char* buffer, int size, char** newbuffer, int* newsize,
+int gpgEncrypt(char* buffer, int size, GPGWRITE_FN writer_cb, void* handle,
     PASSPHRASE_FN password_cb, SHOWERROR_FN showerror_cb)
   {
+    GPGSTREAM           stream;
     gpgme_ctx_t         context;
-    gpgme_data_t        input,
-                        output;
+    gpgme_data_t        input = NULL,
+                        output = NULL;
     gpgme_encrypt_result_t  result;
     gpgme_error_t       error;
     gpgme_key_t*        key = NULL;
@@ -714,7 +703,6 @@ int gpgEncrypt(char* buffer, int size, char** newbuffer, int* newsize,
                         keys = 0,
                         showerror = 1;
     char*               agent;
-    char*               fpr;
     char*               tmpbuffer = NULL;
 
     TRACE(99, "gpgEncrypt()", NULL);
@@ -722,15 +710,16 @@ int gpgEncrypt(char* buffer, int size, char** newbuffer, int* newsize,
     /* we set our passphrase callback function */
     passphrase_callback = password_cb;
 
-    /* we initialize the external size data */
-    newsize[0] = 0;
+    stream.writer = writer_cb;
+    stream.handle = handle;
 
     error = gpgme_new(&context);
 
     if (!error)
       {
-        gpgme_set_textmode(context, 1);
-        gpgme_set_armor(context, 1);
+        /* the data is gzipped, so binary output needs no text mode */
+        gpgme_set_textmode(context, !config -> binaryoutput);
+        gpgme_set_armor(context, !config -> binaryoutput);
 
         /* Flawfinder: ignore */
         agent = getenv("GPG_AGENT_INFO");
@@ -745,7 +734,7 @@ int gpgEncrypt(char* buffer, int size, char** newbuffer, int* newsize,
       { error = gpgme_data_new_from_mem(&input, buffer, size, 0); }
 
     if (!error)
-      { error = gpgme_data_new(&output); }
+      { error = gpgme_data_new_from_cbs(&output, &stream_callbacks, &stream); }
 
     if (!error)
       { gpgme_signers_clear(context); }
@@ -757,27 +746,23 @@ int gpgEncrypt(char* buffer, int size, char** newbuffer, int* newsize,
         key = memAlloc(__FILE__, __LINE__, sizeof(gpgme_key_t) * (keys + 1));
         key[keys] = NULL;
         signers = 0;
+
+        /* all keys we don't know yet are listed at once */
+        gpgKeyCachePrefetch(keyGetList(0), keys);
+
         for (i = 0; i < keys && !error; i++)
           {   /* add all keys */
-            fpr = gpgGetFingerprint(keyGet(i), LIST_SECRET);
-            if (fpr)
+            tkey = gpgGetKey(keyGet(i), LIST_SECRET);
+            if (tkey)
               {
-                error = gpgme_get_key(context, fpr, &tkey, LIST_SECRET);
-                if (tkey -> secret);
-                  {
-                    error = gpgme_signers_add(context, tkey);
-                    signers++;
-                  }
-
-                memFreeString(__FILE__, __LINE__, fpr);
+                error = gpgme_signers_add(context, tkey);
+                signers++;
               }
 
-            fpr = gpgGetFingerprint(keyGet(i), LIST_ALL);
-            if (fpr)
-              {
-                error = gpgme_get_key(context, fpr, &key[i], LIST_ALL);
-                memFreeString(__FILE__, __LINE__, fpr);
-              }
+            /* the array holds its own references to the keys */
+            key[i] = gpgGetKey(keyGet(i), LIST_ALL);
+            if (key[i])
+              { gpgme_key_ref(key[i]); }
           }
       }
 
@@ -821,21 +806,18 @@ int gpgEncrypt(char* buffer, int size, char** newbuffer, int* newsize,
         showerror = !error;
       }
 
-    if (!error)
-      { tmpbuffer = gpgData2Char(output, newsize); }
-
     /* free the keys again */
     i = 0;
     while (key && keys && key[i])
       { gpgme_key_unref(key[i++]); }
     memFree(__FILE__, __LINE__, key, sizeof(gpgme_key_t) * (keys + 1));
 
-    gpgme_data_release(input);
-    gpgme_data_release(output);
+    if (input)
+      { gpgme_data_release(input); }
+    if (output)
+      { gpgme_data_release(output); }
     gpgme_release(context);
 
-    *newbuffer = tmpbuffer;
-
     if (error)
       {
         if (showerror)
@@ -849,83 +831,43 @@ int gpgEncrypt(char* buffer, int size, char** newbuffer, int* newsize,
 
 /* #############################################################################
  *
- * Description    find a fingerprint for the given key
+ * Description    find a usable key for the given key name
  * Author         Harry Brueckner
  * Date           2005-04-07
  * Arguments      keyname       - description string
  *                secret_only   - if set to 1, only secret keys are listed
- * Return         char* with the found fingerprint; the string must be freed
- *                by the caller
+ * Return         gpgme_key_t the first usable key or NULL; the key belongs
+ *                to the key cache, so the caller must take a reference if
+ *                it keeps the key
  */
-char* gpgGetFingerprint(char* keyname, int secret_only)
+gpgme_key_t gpgGetKey(char* keyname, int secret_only)
   {
-    gpgme_ctx_t         context;
+    GPGKEYCACHE*        entry;
     gpgme_key_t         key;
-    gpgme_error_t       error;
-    char*               identifier = NULL;
+    int                 i;
 
-    TRACE(99, "gpgGetFingerprint()", NULL);
+    TRACE(99, "gpgGetKey()", NULL);
 
     if (!config -> encryptdata)
       { return NULL; }
 
-    /* get a new context */
-    error = gpgme_new(&context);
-    if (error)
-      {
-        gpgme_release(context);
-        gpgError(error);
-        return NULL;
-      }
-
-    /* start cycling through the list of keys */
-    error = gpgme_op_keylist_start(context, keyname, secret_only);
-    if (error)
-      {
-        gpgme_release(context);
-        gpgError(error);
-        return NULL;
-      }
+    entry = gpgKeyCacheGet(keyname, secret_only);
+    if (!entry)
+      { return NULL; }
 
-    /* first we look for secret keys */
-    while (!identifier &&
-        !(error = gpgme_op_keylist_next(context, &key)))
+    for (i = 0; i < entry -> keys; i++)
       {   /* take the first key we find */
-        if (!identifier &&
-            !key -> disabled &&
+        key = entry -> key[i];
+        if (!key -> disabled &&
             !key -> expired &&
             !key -> invalid &&
             !key -> revoked)
           {   /* we just use keys we can encrypt for */
-            identifier = memAlloc(__FILE__, __LINE__,
-                strlen(key -> subkeys -> fpr) + 1);
-            strStrncpy(identifier, key -> subkeys -> fpr,
-                strlen(key -> subkeys -> fpr) + 1);
+            return key;
           }
-
-        gpgme_key_unref(key);
       }
 
-    if (error &&
-        gpg_err_code(error) != GPG_ERR_EOF)
-      {    /* we validate the last value of the 'next' operation */
-        gpgme_release(context);
-        gpgError(error);
-        return NULL;
-      }
-
-    /* finish the key listing */
-    error = gpgme_op_keylist_end(context);
-    if (error)
-      {
-        gpgme_release(context);
-        gpgError(error);
-        return NULL;
-      }
-
-    gpgme_release(context);
-
-    return identifier;
+    return NULL;
   }
 
 
@@ -983,12 +925,28 @@ char* gpgGetRealm(const char* desc)
 int gpgGetRecipients(gpgme_recipient_t recipients,
     SHOWERROR_FN showerror_cb)
   {
-    gpgme_recipient_t   recipient = recipients;
+    gpgme_recipient_t   recipient;
+    int                 count = 0,
+                        size = 1;
     char*               keyname = NULL;
     char*               tmpbuffer = NULL;
+    char**              keyids;
 
     TRACE(99, "gpgGetRecipients()", NULL);
 
+    /* the keys of all recipients are listed at once */
+    for (recipient = recipients; recipient; recipient = recipient -> next)
+      { size++; }
+    keyids = memAlloc(__FILE__, __LINE__, size * sizeof(char*));
+    for (recipient = recipients; recipient; recipient = recipient -> next)
+      {
+        if (recipient -> keyid)
+          { keyids[count++] = recipient -> keyid; }
+      }
+    gpgKeyCachePrefetch(keyids, count);
+    memFree(__FILE__, __LINE__, keyids, size * sizeof(char*));
+
+    recipient = recipients;
     while (recipient)
       {
         /* if the keyid is NULL, we skip this key */
@@ -1022,6 +980,361 @@ int gpgGetRecipients(gpgme_recipient_t recipients,
 #endif
 
 
+/* #############################################################################
+ *
+ * Description    create a key cache entry for a key name; the entry is not
+ *                linked into the cache yet
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      const char* pattern - the key name
+ *                int secret          - LIST_SECRET or LIST_ALL
+ * Return         GPGKEYCACHE* the new entry
+ */
+GPGKEYCACHE* gpgKeyCacheCreate(const char* pattern, int secret)
+  {
+    GPGKEYCACHE*        entry;
+
+    TRACE(99, "gpgKeyCacheCreate()", NULL);
+
+    entry = memAlloc(__FILE__, __LINE__, sizeof(GPGKEYCACHE));
+    entry -> next = NULL;
+    entry -> key = NULL;
+    entry -> keys = 0;
+    entry -> secret = secret;
+    entry -> pattern = memAlloc(__FILE__, __LINE__, strlen(pattern) + 1);
+    strStrncpy(entry -> pattern, pattern, strlen(pattern) + 1);
+
+    return entry;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    free a key cache entry and release its keys
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      GPGKEYCACHE* entry  - the entry to free
+ * Return         void
+ */
+void gpgKeyCacheDestroy(GPGKEYCACHE* entry)
+  {
+    int                 i;
+
+    TRACE(99, "gpgKeyCacheDestroy()", NULL);
+
+    for (i = 0; i < entry -> keys; i++)
+      { gpgme_key_unref(entry -> key[i]); }
+    if (entry -> key)
+      {
+        memFree(__FILE__, __LINE__, entry -> key,
+            entry -> keys * sizeof(gpgme_key_t));
+      }
+
+    memFreeString(__FILE__, __LINE__, entry -> pattern);
+    memFree(__FILE__, __LINE__, entry, sizeof(GPGKEYCACHE));
+  }
+
+
+/* #############################################################################
+ *
+ * Description    find the entry of a key name in the key cache
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      const char* pattern - the key name
+ *                int secret          - LIST_SECRET or LIST_ALL
+ * Return         GPGKEYCACHE* the entry or NULL if the key name was not
+ *                listed yet
+ */
+GPGKEYCACHE* gpgKeyCacheFind(const char* pattern, int secret)
+  {
+    GPGKEYCACHE*        entry;
+
+    TRACE(99, "gpgKeyCacheFind()", NULL);
+
+    for (entry = keycache; entry; entry = entry -> next)
+      {
+        if (entry -> secret == secret &&
+            !strcmp(entry -> pattern, pattern))
+          { return entry; }
+      }
+
+    return NULL;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    forget all listed keys; this must be done whenever the list
+ *                of recipients changes, so keys which were imported in the
+ *                meantime are found
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         void
+ */
+void gpgKeyCacheFlush(void)
+  {
+    GPGKEYCACHE*        next;
+
+    TRACE(99, "gpgKeyCacheFlush()", NULL);
+
+    while (keycache)
+      {
+        next = keycache -> next;
+        gpgKeyCacheDestroy(keycache);
+        keycache = next;
+      }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    get the keys of a key name from the key cache; a key name
+ *                which was not listed yet is listed now
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      const char* pattern - the key name
+ *                int secret          - LIST_SECRET or LIST_ALL
+ * Return         GPGKEYCACHE* the entry or NULL if a gpg error occured
+ */
+GPGKEYCACHE* gpgKeyCacheGet(const char* pattern, int secret)
+  {
+    GPGKEYCACHE*        entry;
+    gpgme_ctx_t         context;
+    gpgme_key_t         key;
+    gpgme_error_t       error;
+
+    TRACE(99, "gpgKeyCacheGet()", NULL);
+
+    entry = gpgKeyCacheFind(pattern, secret);
+    if (entry)
+      { return entry; }
+
+    /* get a new context */
+    error = gpgme_new(&context);
+    if (error)
+      {
+        gpgme_release(context);
+        gpgError(error);
+        return NULL;
+      }
+
+    /* start cycling through the list of keys */
+    error = gpgme_op_keylist_start(context, pattern, secret);
+    if (error)
+      {
+        gpgme_release(context);
+        gpgError(error);
+        return NULL;
+      }
+
+    entry = gpgKeyCacheCreate(pattern, secret);
+    while (!(error = gpgme_op_keylist_next(context, &key)))
+      {   /* the entry takes over our reference */
+        entry -> key = memRealloc(__FILE__, __LINE__, entry -> key,
+            entry -> keys * sizeof(gpgme_key_t),
+            (entry -> keys + 1) * sizeof(gpgme_key_t));
+        entry -> key[entry -> keys++] = key;
+      }
+
+    if (gpg_err_code(error) != GPG_ERR_EOF ||
+        (error = gpgme_op_keylist_end(context)))
+      {    /* we validate the last value of the 'next' operation */
+        gpgKeyCacheDestroy(entry);
+        gpgme_release(context);
+        gpgError(error);
+        return NULL;
+      }
+
+    gpgme_release(context);
+
+    entry -> next = keycache;
+    keycache = entry;
+
+    return entry;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    check if a key name starts with a long key id, like the
+ *                names of our recipients do; gpg only looks at the key id
+ *                of such names, so its keys can be told apart in a listing
+ *                of several names
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      const char* pattern - the key name
+ * Return         int 1 if the name starts with a key id, otherwise 0
+ */
+int gpgKeyCacheKeyId(const char* pattern)
+  {
+    int                 i;
+
+    TRACE(99, "gpgKeyCacheKeyId()", NULL);
+
+    for (i = 0; i < KEYID_LENGTH; i++)
+      {
+        if (!isxdigit((unsigned char)pattern[i]))
+          { return 0; }
+      }
+
+    return (!pattern[i] || pattern[i] == ' ');
+  }
+
+
+/* #############################################################################
+ *
+ * Description    list the keys of several key names with a single gpg call;
+ *                only names which start with a key id and were not listed
+ *                yet are listed, all others are listed one by one when they
+ *                are needed
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      char** keynames - the key names
+ *                int count       - number of key names
+ *                int secret      - LIST_SECRET or LIST_ALL
+ * Return         int 1 if a gpg error occured, otherwise 0
+ */
+int gpgKeyCacheList(char** keynames, int count, int secret)
+  {
+    GPGKEYCACHE**       pending;
+    gpgme_ctx_t         context;
+    gpgme_key_t         key;
+    gpgme_error_t       error;
+    int                 i,
+                        j,
+                        size = 0;
+    const char**        patterns;
+
+    TRACE(99, "gpgKeyCacheList()", NULL);
+
+    pending = memAlloc(__FILE__, __LINE__, (count + 1) * sizeof(GPGKEYCACHE*));
+    patterns = memAlloc(__FILE__, __LINE__, (count + 1) * sizeof(char*));
+    for (i = 0; i < count; i++)
+      {
+        if (!keynames[i] ||
+            !gpgKeyCacheKeyId(keynames[i]) ||
+            gpgKeyCacheFind(keynames[i], secret))
+          { continue; }
+
+        for (j = 0; j < size; j++)
+          {
+            if (!strcmp(patterns[j], keynames[i]))
+              { break; }
+          }
+        if (j < size)
+          { continue; }   /* the name is listed already */
+
+        pending[size] = gpgKeyCacheCreate(keynames[i], secret);
+        patterns[size] = pending[size] -> pattern;
+        size++;
+      }
+    patterns[size] = NULL;
+
+    error = 0;
+    if (size)
+      { error = gpgme_new(&context); }
+    if (size && !error)
+      {
+        error = gpgme_op_keylist_ext_start(context, patterns, secret, 0);
+        while (!error &&
+            !(error = gpgme_op_keylist_next(context, &key)))
+          {   /* every key goes to the names which ask for its key id */
+            for (i = 0; i < size; i++)
+              {
+                if (!gpgKeyCacheMatch(pending[i] -> pattern, key))
+                  { continue; }
+
+                pending[i] -> key = memRealloc(__FILE__, __LINE__,
+                    pending[i] -> key,
+                    pending[i] -> keys * sizeof(gpgme_key_t),
+                    (pending[i] -> keys + 1) * sizeof(gpgme_key_t));
+                gpgme_key_ref(key);
+                pending[i] -> key[pending[i] -> keys++] = key;
+              }
+
+            gpgme_key_unref(key);
+          }
+
+        if (gpg_err_code(error) == GPG_ERR_EOF)
+          { error = gpgme_op_keylist_end(context); }
+      }
+    if (size)
+      { gpgme_release(context); }
+
+    for (i = 0; i < size; i++)
+      {
+        if (error)
+          { gpgKeyCacheDestroy(pending[i]); }
+        else
+          {
+            pending[i] -> next = keycache;
+            keycache = pending[i];
+          }
+      }
+
+    memFree(__FILE__, __LINE__, pending, (count + 1) * sizeof(GPGKEYCACHE*));
+    memFree(__FILE__, __LINE__, patterns, (count + 1) * sizeof(char*));
+
+    if (error)
+      {
+        gpgError(error);
+        return 1;
+      }
+    else
+      { return 0; }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    check if a key has the key id a key name starts with
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      const char* pattern - the key name
+ *                gpgme_key_t key     - the key to check
+ * Return         int 1 if the key matches the name, otherwise 0
+ */
+int gpgKeyCacheMatch(const char* pattern, gpgme_key_t key)
+  {
+    gpgme_subkey_t      subkey;
+
+    TRACE(99, "gpgKeyCacheMatch()", NULL);
+
+    for (subkey = key -> subkeys; subkey; subkey = subkey -> next)
+      {
+        if (subkey -> keyid &&
+            !strncasecmp(subkey -> keyid, pattern, KEYID_LENGTH))
+          { return 1; }
+      }
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    list the secret and the public keys of several key names,
+ *                so the following lookups of these names need no gpg call
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      char** keynames - the key names
+ *                int count       - number of key names
+ * Return         int 1 if a gpg error occured, otherwise 0
+ */
+int gpgKeyCachePrefetch(char** keynames, int count)
+  {
+    TRACE(99, "gpgKeyCachePrefetch()", NULL);
+
+    if (!config -> encryptdata ||
+        !count)
+      { return 0; }
+
+    return (gpgKeyCacheList(keynames, count, LIST_SECRET) ||
+        gpgKeyCacheList(keynames, count, LIST_ALL));
+  }
+
+
 /* #############################################################################
  *
  * Description    request the users passphrase for the de-/encryption process
@@ -1104,6 +1417,33 @@ gpgme_error_t gpgRequestPassphrase(void *hook, const char *uid_hint,
   }
 
 
+/* #############################################################################
+ *
+ * Description    GpgMe write callback which forwards decrypted data to the
+ *                writer function given to gpgDecrypt
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void* handle        - GPGSTREAM of the current operation
+ *                const void* buffer  - data to write
+ *                size_t size         - size of the data
+ * Return         number of bytes written or -1 on error
+ */
+ssize_t gpgStreamWrite(void* handle, const void* buffer, size_t size)
+  {
+    GPGSTREAM*          stream = (GPGSTREAM*)handle;
+
+    TRACE(99, "gpgStreamWrite()", NULL);
+
+    if ((stream -> writer)(stream -> handle, (const char*)buffer, size))
+      {
+        errno = EIO;
+        return -1;
+      }
+
+    return size;
+  }
+
+
 /* #############################################################################
  *
  * Description    check if for the given keyname a secret key exists
@@ -1115,37 +1455,23 @@ gpgme_error_t gpgRequestPassphrase(void *hook, const char *uid_hint,
  */
 int gpgIsSecretKey(char* keyname)
   {
-    gpgme_ctx_t         context;
+    GPGKEYCACHE*        entry;
     gpgme_key_t         key;
-    gpgme_error_t       error;
-    int                 secret = 0;
+    int                 i;
 
     TRACE(99, "gpgIsSecretKey()", NULL);
 
     if (!config -> encryptdata)
       { return 0; }
 
-    /* get a new context */
-    error = gpgme_new(&context);
-    if (error)
-      {
-        gpgme_release(context);
-        gpgError(error);
-        return -1;
-      }
-
-    /* start cycling through the list of keys */
-    error = gpgme_op_keylist_start(context, keyname, LIST_SECRET);
-    if (error)
-      {
-        gpgme_release(context);
-        gpgError(error);
-        return -1;
-      }
+    entry = gpgKeyCacheGet(keyname, LIST_SECRET);
+    if (!entry)
+      { return -1; }
 
-    while (!(error = gpgme_op_keylist_next(context, &key)))
+    for (i = 0; i < entry -> keys; i++)
       {   /* take the first usable key we find */
         /* TODO: only choose usable secret keys */
+        key = entry -> key[i];
         if (key -> can_encrypt &&
             key -> secret &&
             !key -> disabled &&
@@ -1153,35 +1479,11 @@ int gpgIsSecretKey(char* keyname)
             !key -> invalid &&
             !key -> revoked)
           {   /* we just use keys we can encrypt for */
-            secret = 1;
+            return 1;
           }
-
-        gpgme_key_unref(key);
-
-        if (secret)
-          { break; }
-      }
-
-    if (error &&
-        gpg_err_code(error) != GPG_ERR_EOF)
-      {    /* we validate the last value of the 'next' operation */
-        gpgme_release(context);
-        gpgError(error);
-        return -1;
       }
 
-    /* finish the key listing */
-    error = gpgme_op_keylist_end(context);
-    if (error)
-      {
-        gpgme_release(context);
-        gpgError(error);
-        return -1;
-      }
-
-    gpgme_release(context);
-
-    return secret;
+    return 0;
   }
 
 
@@ -1195,10 +1497,10 @@ int gpgIsSecretKey(char* keyname)
  */
 char* gpgValidateEncryptionKey(char* keyname)
   {
-    gpgme_ctx_t         context;
+    GPGKEYCACHE*        entry;
     gpgme_key_t         key;
-    gpgme_error_t       error;
-    int                 secret,
+    int                 i,
+                        secret,
                         size;
     char*               identifier = NULL;
     char*               tcomment;
@@ -1209,29 +1511,16 @@ char* gpgValidateEncryptionKey(char* keyname)
     if (!config -> encryptdata)
       { return NULL; }
 
-    /* get a new context */
-    error = gpgme_new(&context);
-    if (error)
-      {
-        gpgme_release(context);
-        gpgError(error);
-        return NULL;
-      }
-
     for (secret = 1; secret >= 0 && !identifier; secret--)
       {
-        /* start cycling through the list of keys */
-        error = gpgme_op_keylist_start(context, keyname,
+        entry = gpgKeyCacheGet(keyname,
             (secret == 1) ? LIST_SECRET : LIST_ALL);
-        if (error)
-          {
-            gpgme_release(context);
-            gpgError(error);
-            return NULL;
-          }
+        if (!entry)
+          { return NULL; }
 
-        while (!(error = gpgme_op_keylist_next(context, &key)))
+        for (i = 0; i < entry -> keys && !identifier; i++)
           {   /* take the first key we find */
+            key = entry -> key[i];
 #ifdef TEST_OPTION
   #ifdef KEY_DEBUG
             gpgDebugKey(key);
@@ -1274,33 +1563,9 @@ char* gpgValidateEncryptionKey(char* keyname)
                         key -> uids -> email);
                   }
               }
-
-            gpgme_key_unref(key);
-
-            if (identifier)
-              { break; }
           }
-
-        if (error &&
-            gpg_err_code(error) != GPG_ERR_EOF)
-          {    /* we validate the last value of the 'next' operation */
-            gpgme_release(context);
-            gpgError(error);
-            return NULL;
-          }
-      }
-
-    /* finish the key listing */
-    error = gpgme_op_keylist_end(context);
-    if (error)
-      {
-        gpgme_release(context);
-        gpgError(error);
-        return NULL;
       }
 
-    gpgme_release(context);
-
     return identifier;
   }
 
@@ -1338,6 +1603,7 @@ void initGPG(void)
     retries = 0;
     signers = 0;
     lastrealm = NULL;
+    keycache = NULL;
   }
 
 
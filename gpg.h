@@ -35,6 +35,7 @@
  */
 #define GPG_VERSION_MINIMUM "1.0.2"
 typedef const char* (*PASSPHRASE_FN) (int retry, char* realm);
+typedef int (*GPGWRITE_FN) (void* handle, const char* buffer, int size);
 
 
 /* #############################################################################
@@ -42,11 +43,13 @@ typedef const char* (*PASSPHRASE_FN) (int retry, char* realm);
  */
 void freeGPG(void);
 void initGPG(void);
-int gpgDecrypt(char* buffer, int size, char** newbuffer, int* newsize,
-    PASSPHRASE_FN password_cb, SHOWERROR_FN showerror_cb);
-int gpgEncrypt(char* buffer, int size, char** newbuffer, int* newsize,
+int gpgDecrypt(int fd, gpgme_data_encoding_t encoding, GPGWRITE_FN writer_cb,
+    void* handle, PASSPHRASE_FN password_cb, SHOWERROR_FN showerror_cb);
+int gpgEncrypt(char* buffer, int size, GPGWRITE_FN writer_cb, void* handle,
     PASSPHRASE_FN password_cb, SHOWERROR_FN showerror_cb);
 int gpgIsSecretKey(char* keyname);
+void gpgKeyCacheFlush(void);
+int gpgKeyCachePrefetch(char** keynames, int count);
 char* gpgValidateEncryptionKey(char* keyname);
 
 
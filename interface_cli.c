@@ -26,10 +26,15 @@
  */
 #include "cpm.h"
 #include <regex.h>
+#ifdef HAVE_LIBPTHREAD
+  #include <pthread.h>
+#endif
 #ifdef HAVE_TERMIOS_H
   #include <termios.h>
 #endif
+#include "agent.h"
 #include "configuration.h"
+#include "dfa.h"
 #include "general.h"
 #include "interface_cli.h"
 #include "interface_keys.h"
@@ -42,29 +47,169 @@
 #include "xml.h"
 
 
+/* #############################################################################
+ * global interface variables
+ */
+#define SEARCH_MAXTHREADS     64
+#define CLI_TERMINAL          "/dev/tty"
+
+typedef struct sCliSearch CLISEARCH;
+struct sCliSearch
+  {
+    LIST*               result;
+    MEMARENA*           arena;      /* temporary strings of a single node */
+    WALKPATH            path;
+    DFACACHE*           dfa;        /* cache of the builtin regex engine */
+    int*                dfastate;   /* DFA states of all pattern parts */
+    regex_t             regex;
+    int*                hash;       /* indices into the result list */
+    int                 hashsize,
+                        regexready; /* regex holds a compiled expression */
+#ifdef HAVE_LIBPTHREAD
+    pthread_t           thread;
+#endif
+  };
+
+static struct           termios terminalsettings;
+DFA*                    clidfa = NULL;
+char*                   clidfapattern = NULL;
+int                     clidfacasesensitive = 0;
+CLISEARCH*              cliworker = NULL;
+int                     cliworkers = 0;
+xmlNode**               clinode = NULL;
+int                     clinodecount = 0,
+                        clinodenext = 0;
+#ifdef HAVE_LIBPTHREAD
+pthread_mutex_t         clinodelock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+char*                   clisearchpattern = NULL;
+char*                   clisearchquery = NULL;
+#ifdef TEST_OPTION
+static const char*      testregex[] =
+  {
+    "a1",
+    "[0-9][A-Z][a-z]",
+    "^[a-z]+ ",
+    "[0-9]$",
+    "(ab|cd|ef)[^a-z]",
+    "x.y",
+    "Q+R?S*T",
+    "@[[:digit:]]",
+    "[[:upper:]][[:upper:]][[:upper:]]",
+    "^(a|b)*c",
+    "z{2}",
+    "\\<a",
+    NULL
+  };
+#endif
+
+
 /* #############################################################################
  * internal functions
  */
-void cliEchoOff(void);
-void cliEchoOn(void);
+int cliBatch(void);
+void cliEchoOff(int fd);
+void cliEchoOn(int fd);
 const char* cliDialogPassphrase(int retry, char* realm);
+int cliResultAdd(CLISEARCH* search, char* result);
+void cliResultClear(CLISEARCH* search);
+void cliResultFree(CLISEARCH* search);
+void cliSearchCompile(void);
+void cliSearchCreate(void);
+void cliSearchFree(void);
+int cliSearchRun(void);
+void* cliSearchWorker(void* data);
 void cliShowError(const char* headline, const char* message);
-int cliTreeWalk(char** path);
-int prepareSearchexpression(void);
+int cliTreeWalk(WALKPATH* path);
+int prepareSearchexpression(regex_t* regex);
+#ifdef TEST_OPTION
+  void testRegex(void);
+#endif
 
 
 /* #############################################################################
- * global interface variables
+ *
+ * Description    read search queries from stdin and run each one against the
+ *                database which is only decrypted once; every result is
+ *                followed by the delimiter and an empty record ends the
+ *                results of each query
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         int 0 if all is ok, 1 if any query failed
  */
-regex_t                 searchregex;
-static struct           termios terminalsettings;
-char**                  searchresult = NULL;
-char*                   clisearchpattern = NULL;
+int cliBatch(void)
+  {
+    int                 code,
+                        error = 0,
+                        i,
+                        length = 0,
+                        size = STDSTRINGLENGTH;
+    char                delimiter = config -> batchdelimiter;
+
+    TRACE(99, "cliBatch()", NULL);
+
+    clisearchpattern = memAlloc(__FILE__, __LINE__, size);
+
+    while (1)
+      {
+        code = fgetc(stdin);
+        if (code != EOF &&
+            (char)code != delimiter)
+          {
+            if (length + 1 >= size)
+              {
+                clisearchpattern = memRealloc(__FILE__, __LINE__,
+                    clisearchpattern, size, size * 2);
+                size *= 2;
+              }
+            clisearchpattern[length++] = (char)code;
+            continue;
+          }
+
+        if (code == EOF &&
+            !length)
+          {   /* the last query was terminated already */
+            break;
+          }
+
+        clisearchpattern[length] = 0;
+        if (length)
+          {
+            if (cliSearchRun())
+              { error = 1; }
+            else
+              {
+                for (i = 0; i < cliworker[0].result -> count; i++)
+                  {
+                    fputs(cliworker[0].result -> item[i], stdout);
+                    fputc(delimiter, stdout);
+                  }
+              }
+          }
+        fputc(delimiter, stdout);
+
+        /* the caller might wait for this answer before sending more */
+        fflush(stdout);
+        length = 0;
+
+        if (code == EOF)
+          { break; }
+      }
+
+    memFree(__FILE__, __LINE__, clisearchpattern, size);
+    clisearchpattern = NULL;
+    cliSearchFree();
+
+    return error;
+  }
 
 
 /* #############################################################################
  *
- * Description    cli dialog to request the passphrase
+ * Description    cli dialog to request the passphrase; in batch mode stdin
+ *                and stdout carry the queries and results, so the prompt
+ *                goes to stderr and the passphrase is read from the terminal
  * Author         Harry Brueckner
  * Date           2005-04-03
  * Arguments      int retry           - number of this retry
@@ -73,20 +218,39 @@ char*                   clisearchpattern = NULL;
  */
 const char* cliDialogPassphrase(int retry, char* realm)
   {
+    FILE*               input = stdin;
+    FILE*               output = stdout;
     int                 ret,
                         size = 0;
 
     TRACE(99, "cliDialogPassphrase()", NULL);
 
-    printf(_("enter your passphrase (try #%d)\n%s\n"),
+    if (config -> batch)
+      { output = stderr; }
+
+    fprintf(output, _("enter your passphrase (try #%d)\n%s\n"),
         retry,
         realm);
+    fflush(output);
 
     if (strlen(runtime -> passphrase))
       { return runtime -> passphrase; }
 
-    cliEchoOff();
-    while ((ret = fgetc(stdin)) && size < PASSPHRASE_LENGTH)
+    if (config -> batch)
+      {
+        /* Flawfinder: ignore */
+        input = fopen(CLI_TERMINAL, "r");
+        if (!input)
+          {
+            fprintf(stderr,
+                _("error: no terminal to read the passphrase from.\n"));
+            return runtime -> passphrase;
+          }
+      }
+
+    cliEchoOff(fileno(input));
+    while ((ret = fgetc(input)) != EOF &&
+        size < PASSPHRASE_LENGTH)
       {
         if ((char)ret == '\n')
           { break; }
@@ -94,7 +258,10 @@ const char* cliDialogPassphrase(int retry, char* realm)
         runtime -> passphrase[size++] = (char)ret;
         runtime -> passphrase[size] = 0;
       }
-    cliEchoOn();
+    cliEchoOn(fileno(input));
+
+    if (input != stdin)
+      { fclose(input); }
 
     return runtime -> passphrase;
   }
@@ -105,21 +272,21 @@ const char* cliDialogPassphrase(int retry, char* realm)
  * Description    turn the cli echo off
  * Author         Harry Brueckner
  * Date           2005-04-03
- * Arguments      void
+ * Arguments      int fd  - terminal to turn the echo off for
  * Return         void
  */
-void cliEchoOff(void)
+void cliEchoOff(int fd)
   {
     struct termios new_settings;
 
     TRACE(99, "cliEchoOff()", NULL);
 
-    tcgetattr(0, &terminalsettings);
+    tcgetattr(fd, &terminalsettings);
 
     new_settings = terminalsettings;
     new_settings.c_lflag &= (~ECHO);
 
-    tcsetattr(0, TCSANOW, &new_settings);
+    tcsetattr(fd, TCSANOW, &new_settings);
   }
 
 
@@ -128,15 +295,15 @@ void cliEchoOff(void)
  * Description    turn the cli echo on
  * Author         Harry Brueckner
  * Date           2005-04-03
- * Arguments      void
+ * Arguments      int fd  - terminal to turn the echo on for
  * Return         void
  */
-void cliEchoOn(void)
+void cliEchoOn(int fd)
   {
     TRACE(99, "cliEchoOn()", NULL);
 
     if(terminalsettings.c_lflag){
-    tcsetattr(0, TCSANOW, &terminalsettings);
+    tcsetattr(fd, TCSANOW, &terminalsettings);
   }
   }
 
@@ -152,11 +319,7 @@ void cliEchoOn(void)
  */
 int cliInterface(void)
   {
-    int                 error,
-                        found = 0,
-                        i,
-                        size;
-    char***             path = NULL;
+    int                 error;
     char*               errormsg;
 
     TRACE(99, "cliInterface()", NULL);
@@ -168,6 +331,28 @@ int cliInterface(void)
         exit(1);
       }
 
+    /* we must check if the user owerwrites our configuration */
+    if (runtime -> casesensitive == -1)
+      { runtime -> casesensitive = config -> casesensitive; }
+    if (runtime -> searchtype == SEARCH_UNDEF)
+      { runtime -> searchtype = config -> searchtype; }
+
+    /* if an agent holds our database, it can answer the search right away
+     * and we don't have to decrypt anything
+     */
+#ifdef TEST_OPTION
+    if (!config -> agent &&
+        !config -> batch &&
+        !config -> testrun &&
+        !agentQuery(&error))
+      { return error; }
+#else
+    if (!config -> agent &&
+        !config -> batch &&
+        !agentQuery(&error))
+      { return error; }
+#endif
+
     if (xmlDataFileRead(runtime -> dbfile, &errormsg,
         cliDialogPassphrase, cliShowError))
       {
@@ -210,12 +395,164 @@ int cliInterface(void)
         return 2;
       }
 
+    if (config -> testrun &&
+        !strcmp("treewalk", config -> testrun))
+      {
+        testTreeWalk();
+        return 2;
+      }
+
+    if (config -> testrun &&
+        !strcmp("regex", config -> testrun))
+      {
+        testRegex();
+        return 2;
+      }
+
     /* we only return 2 if we don't want to test the CLI search */
     if (config -> testrun &&
         strcmp("clisearch", config -> testrun))
       { return 2; }
 #endif
 
+    if (config -> agent)
+      {   /* we keep the database and answer the searches of other calls */
+        return agentServe();
+      }
+    if (config -> batch)
+      {   /* the queries come from stdin */
+        return cliBatch();
+      }
+
+    return cliSearch();
+  }
+
+
+/* #############################################################################
+ *
+ * Description    add a result to the result list of a search unless it's
+ *                already there; a hash table of indices into the list finds
+ *                duplicates
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      CLISEARCH* search   - the search to add the result to
+ *                char* result        - the result to add
+ * Return         int 1 if the result was added, 0 if it already existed
+ */
+int cliResultAdd(CLISEARCH* search, char* result)
+  {
+    unsigned int        hash;
+    int                 i,
+                        id,
+                        size;
+
+    TRACE(99, "cliResultAdd()", NULL);
+
+    /* we keep the hash table at most half full */
+    if ((search -> result -> count + 1) * 2 > search -> hashsize)
+      {
+        size = (search -> hashsize) ? search -> hashsize * 2 : 64;
+        if (search -> hash)
+          {
+            memFree(__FILE__, __LINE__, search -> hash,
+                search -> hashsize * sizeof(int));
+          }
+        search -> hash = memAlloc(__FILE__, __LINE__, size * sizeof(int));
+        search -> hashsize = size;
+
+        for (i = 0; i < size; i++)
+          { search -> hash[i] = -1; }
+        for (id = 0; id < search -> result -> count; id++)
+          {
+            i = strHash(search -> result -> item[id]) & (size - 1);
+            while (search -> hash[i] != -1)
+              { i = (i + 1) & (size - 1); }
+            search -> hash[i] = id;
+          }
+      }
+
+    hash = strHash(result);
+    i = hash & (search -> hashsize - 1);
+    while (search -> hash[i] != -1)
+      {
+        if (!strcmp(search -> result -> item[search -> hash[i]], result))
+          {   /* this result already exists, nothing to do */
+            return 0;
+          }
+        i = (i + 1) & (search -> hashsize - 1);
+      }
+
+    search -> hash[i] = search -> result -> count;
+    listAppend(search -> result, result);
+
+    return 1;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    empty the result list of a search but keep its memory for
+ *                the next search
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      CLISEARCH* search   - the search to clear
+ * Return         void
+ */
+void cliResultClear(CLISEARCH* search)
+  {
+    int                 i;
+
+    TRACE(99, "cliResultClear()", NULL);
+
+    while (search -> result -> count)
+      { listPop(search -> result); }
+    for (i = 0; i < search -> hashsize; i++)
+      { search -> hash[i] = -1; }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    free the result list of a search
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      CLISEARCH* search   - the search to free the results of
+ * Return         void
+ */
+void cliResultFree(CLISEARCH* search)
+  {
+    TRACE(99, "cliResultFree()", NULL);
+
+    search -> result = listDestroy(search -> result);
+    if (search -> hash)
+      {
+        memFree(__FILE__, __LINE__, search -> hash,
+            search -> hashsize * sizeof(int));
+      }
+
+    search -> hash = NULL;
+    search -> hashsize = 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    search the loaded database for the search data given on the
+ *                commandline and print the results
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         int 0 if all is ok, 1 on error
+ */
+int cliSearch(void)
+  {
+    int                 error,
+                        found,
+                        i,
+                        size;
+
+    TRACE(99, "cliSearch()", NULL);
+
     if (!config -> searchdata)
       {
         fprintf(stderr, _("error: no searchpattern given.\n"));
@@ -241,45 +578,17 @@ int cliInterface(void)
         i++;
       }
 
-    /* we must check if the user owerwrites our configuration */
-    if (runtime -> casesensitive == -1)
-      { runtime -> casesensitive = config -> casesensitive; }
-    if (runtime -> searchtype == SEARCH_UNDEF)
-      { runtime -> searchtype = config -> searchtype; }
-
-    /* we initialize the results list */
-    searchresult = NULL;
-
-    /* we build our regular expression */
-    if (prepareSearchexpression())
-      {
-        /* we cycle through the list and try to find all matches */
-        path = memAlloc(__FILE__, __LINE__, sizeof(char**));
-        *path = NULL;
-        found = xmlInterfaceTreeWalk(NULL, path, cliTreeWalk);
-        memFree(__FILE__, __LINE__, path, sizeof(char**));
+    error = cliSearchRun();
 
-        if (runtime -> searchtype == SEARCH_REGEX)
-          { regfree(&searchregex); }
-
-        error = 0;
-      }
-    else
-      { error = 1; }
-
-
-    if (clisearchpattern)
-      { memFreeString(__FILE__, __LINE__, clisearchpattern); }
+    memFreeString(__FILE__, __LINE__, clisearchpattern);
+    clisearchpattern = NULL;
 
     if (!error)
       {
-        if (found)
-          {   /* we have something to display */
-            listSort(searchresult);
-            for (i = 0; i < found; i++)
-              {
-                printf("%s\n", searchresult[i]);
-              }
+        found = cliworker[0].result -> count;
+        for (i = 0; i < found; i++)
+          {
+            printf("%s\n", cliworker[0].result -> item[i]);
           }
         switch (found)
           {
@@ -296,12 +605,316 @@ int cliInterface(void)
       }
 
     /* we clean up the results */
-    searchresult = listFree(searchresult);
+    cliSearchFree();
 
     return 0;
   }
 
 
+/* #############################################################################
+ *
+ * Description    compile the regular expression of the search for the
+ *                builtin engine; the DFA and the caches of the threads are
+ *                kept as long as the same expression is searched for, so a
+ *                batch or an agent which repeats a search starts with the
+ *                states of the last one; if the engine can't compile the
+ *                expression, clidfa is NULL and regcomp() is used
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         void
+ */
+void cliSearchCompile(void)
+  {
+    int                 i;
+
+    TRACE(99, "cliSearchCompile()", NULL);
+
+    if (clidfapattern &&
+        (config -> regexengine != REGEX_BUILTIN ||
+         clidfacasesensitive != runtime -> casesensitive ||
+         strcmp(clidfapattern, clisearchpattern)))
+      {   /* the old expression is no longer needed */
+        for (i = 0; i < cliworkers; i++)
+          {
+            dfaCacheFree(cliworker[i].dfa);
+            cliworker[i].dfa = NULL;
+          }
+        dfaFree(clidfa);
+        clidfa = NULL;
+        memFreeString(__FILE__, __LINE__, clidfapattern);
+        clidfapattern = NULL;
+      }
+
+    if (config -> regexengine != REGEX_BUILTIN ||
+        clidfapattern)
+      { return; }
+
+    clidfa = dfaCompile(clisearchpattern, runtime -> casesensitive);
+    clidfacasesensitive = runtime -> casesensitive;
+    clidfapattern = memAlloc(__FILE__, __LINE__,
+        strlen(clisearchpattern) + 1);
+    strStrncpy(clidfapattern, clisearchpattern,
+        strlen(clisearchpattern) + 1);
+  }
+
+
+/* #############################################################################
+ *
+ * Description    create the searches for all threads of the CLI search; the
+ *                first one also collects the results of all others
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         void
+ */
+void cliSearchCreate(void)
+  {
+    int                 i;
+
+    TRACE(99, "cliSearchCreate()", NULL);
+
+    cliworkers = 1;
+#ifdef HAVE_LIBPTHREAD
+    if (config -> searchthreads)
+      { cliworkers = config -> searchthreads; }
+    else
+      {   /* by default we use one thread per processor */
+        cliworkers = sysconf(_SC_NPROCESSORS_ONLN);
+      }
+    cliworkers = max(1, min(cliworkers, SEARCH_MAXTHREADS));
+#endif
+
+    cliworker = memAlloc(__FILE__, __LINE__, cliworkers * sizeof(CLISEARCH));
+    for (i = 0; i < cliworkers; i++)
+      {
+        cliworker[i].result = listCreate();
+        cliworker[i].arena = memArenaCreate(0);
+        cliworker[i].hash = NULL;
+        cliworker[i].hashsize = 0;
+        cliworker[i].regexready = 0;
+        cliworker[i].dfa = NULL;
+        cliworker[i].dfastate = memAlloc(__FILE__, __LINE__,
+            max(1, patternPartCount()) * sizeof(int));
+        xmlInterfaceWalkPathInit(&cliworker[i].path);
+        cliworker[i].path.data = &cliworker[i];
+      }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    free all searches of the CLI search
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         void
+ */
+void cliSearchFree(void)
+  {
+    int                 i;
+
+    TRACE(99, "cliSearchFree()", NULL);
+
+    if (!cliworker)
+      { return; }
+
+    for (i = 0; i < cliworkers; i++)
+      {
+        cliResultFree(&cliworker[i]);
+        memArenaFree(cliworker[i].arena);
+        dfaCacheFree(cliworker[i].dfa);
+        memFree(__FILE__, __LINE__, cliworker[i].dfastate,
+            max(1, patternPartCount()) * sizeof(int));
+        xmlInterfaceWalkPathFree(&cliworker[i].path);
+      }
+
+    dfaFree(clidfa);
+    clidfa = NULL;
+    if (clidfapattern)
+      { memFreeString(__FILE__, __LINE__, clidfapattern); }
+    clidfapattern = NULL;
+
+    memFree(__FILE__, __LINE__, cliworker, cliworkers * sizeof(CLISEARCH));
+    cliworker = NULL;
+    cliworkers = 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    run the search for clisearchpattern against the loaded
+ *                database; the nodes below the root are handed out to one
+ *                thread per search and the results of all threads are merged
+ *                into the first search, where they are left sorted
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         int 0 if all is ok, 1 on error
+ */
+int cliSearchRun(void)
+  {
+    xmlNode*            curnode;
+    int                 compiled,
+                        error = 0,
+                        i,
+                        id,
+                        nodes = 0,
+                        threads;
+    char*               query;
+
+    TRACE(99, "cliSearchRun()", NULL);
+
+    if (!cliworker)
+      { cliSearchCreate(); }
+
+    /* the labels of the tree are compared in UTF-8, so we convert the
+     * search string only once
+     */
+    query = (char*)convert2xml(clisearchpattern);
+    if (!query)
+      { query = clisearchpattern; }
+    clisearchquery = memAlloc(__FILE__, __LINE__, strlen(query) + 1);
+    strStrncpy(clisearchquery, query, strlen(query) + 1);
+
+    /* the search threads only read the data of the nodes, so the labels
+     * must be converted and folded before they start
+     */
+    xmlInterfaceShadowLabels();
+
+    /* a case insensitive literal search compares the folded query with the
+     * folded labels, which are only folded once for all searches
+     */
+    if (runtime -> searchtype != SEARCH_REGEX &&
+        !runtime -> casesensitive)
+      {
+        strFold(clisearchquery, query);
+        xmlInterfaceFoldLabels();
+      }
+
+    /* we collect the nodes the threads take their work from */
+    for (curnode = xmlGetDocumentRoot() -> children; curnode;
+        curnode = curnode -> next)
+      { nodes++; }
+    clinode = memAlloc(__FILE__, __LINE__, max(1, nodes) * sizeof(xmlNode*));
+    clinodecount = clinodenext = 0;
+    for (curnode = xmlGetDocumentRoot() -> children; curnode;
+        curnode = curnode -> next)
+      {
+        if (curnode -> type == XML_ELEMENT_NODE &&
+            !strcmp((char*)curnode -> name, "node"))
+          { clinode[clinodecount++] = curnode; }
+      }
+    threads = max(1, min(cliworkers, clinodecount));
+
+    if (runtime -> searchtype == SEARCH_REGEX)
+      { cliSearchCompile(); }
+
+    /* every thread needs its own copy of the regular expression or its own
+     * cache of the DFA which all threads share
+     */
+    for (compiled = 0; compiled < threads; compiled++)
+      {
+        cliResultClear(&cliworker[compiled]);
+        cliworker[compiled].regexready = 0;
+        if (runtime -> searchtype == SEARCH_REGEX &&
+            clidfa)
+          {   /* the expression is only compiled if the DFA gives up */
+            if (!cliworker[compiled].dfa)
+              { cliworker[compiled].dfa = dfaCacheCreate(clidfa); }
+          }
+        else if (!prepareSearchexpression(&cliworker[compiled].regex))
+          {
+            error = 1;
+            break;
+          }
+        else
+          {
+            cliworker[compiled].regexready =
+                (runtime -> searchtype == SEARCH_REGEX);
+          }
+      }
+
+    if (!error)
+      {
+#ifdef HAVE_LIBPTHREAD
+        for (i = 1; i < threads; i++)
+          {
+            if (pthread_create(&cliworker[i].thread, NULL, cliSearchWorker,
+                &cliworker[i]))
+              {   /* if we can't start a thread, the others do the work */
+                break;
+              }
+          }
+        threads = i;
+#endif
+        cliSearchWorker(&cliworker[0]);
+
+        for (i = 1; i < threads; i++)
+          {
+#ifdef HAVE_LIBPTHREAD
+            pthread_join(cliworker[i].thread, NULL);
+#endif
+            for (id = 0; id < cliworker[i].result -> count; id++)
+              { cliResultAdd(&cliworker[0], cliworker[i].result -> item[id]); }
+            cliResultClear(&cliworker[i]);
+          }
+
+        listSort(cliworker[0].result -> item);
+      }
+
+    for (i = 0; i < compiled; i++)
+      {
+        if (cliworker[i].regexready)
+          { regfree(&cliworker[i].regex); }
+        cliworker[i].regexready = 0;
+      }
+
+    memFree(__FILE__, __LINE__, clinode, max(1, nodes) * sizeof(xmlNode*));
+    clinode = NULL;
+    memFreeString(__FILE__, __LINE__, clisearchquery);
+    clisearchquery = NULL;
+
+    return error;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    search thread of the CLI search; it takes one node below
+ *                the root after the other and walks through it until all
+ *                nodes are searched
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void* data  - the CLISEARCH of the thread
+ * Return         void* NULL
+ */
+void* cliSearchWorker(void* data)
+  {
+    CLISEARCH*          search = data;
+    int                 id;
+
+    TRACE(99, "cliSearchWorker()", NULL);
+
+    while (1)
+      {
+#ifdef HAVE_LIBPTHREAD
+        pthread_mutex_lock(&clinodelock);
+#endif
+        id = clinodenext++;
+#ifdef HAVE_LIBPTHREAD
+        pthread_mutex_unlock(&clinodelock);
+#endif
+        if (id >= clinodecount)
+          { break; }
+
+        xmlInterfaceTreeWalkNode(clinode[id], cliTreeWalk, &search -> path);
+      }
+
+    return NULL;
+  }
+
+
 /* #############################################################################
  *
  * Description    show a error message to the user
@@ -321,79 +934,101 @@ void cliShowError(const char* headline, const char* message)
 /* #############################################################################
  *
  * Description    callback function for xml tree walking; in this function
- *                we search for any matches
+ *                we search for any matches and decide if the nodes below the
+ *                path can match at all; all data of the search comes from
+ *                the CLISEARCH of the path, so several threads can search at
+ *                the same time
  * Author         Harry Brueckner
  * Date           2005-04-06
- * Arguments      char** path   - path we are currently at
- * Return         int number of found matches
+ * Arguments      WALKPATH* path  - path we are currently at
+ * Return         int WALK_CONTINUE if the children must be searched,
+ *                otherwise WALK_SKIP
  */
-int cliTreeWalk(char** path)
+int cliTreeWalk(WALKPATH* path)
   {
+    CLISEARCH*          search = path -> data;
     int                 cmp,
-                        i = 0,
-                        l,
-                        lexist,
-                        lsize,
-                        found = 0;
+                        dfa,
+                        i = 0;
     char**              pattern = runtime -> searchpatterns;
     char*               cstring = NULL;
     char*               cresult = NULL;
 
     TRACE(99, "cliTreeWalk()", NULL);
 
+    dfa = (runtime -> searchtype == SEARCH_REGEX && clidfa);
+    if (dfa)
+      {   /* the DFA states of the pattern parts belong to a single path */
+        dfaCacheTrim(search -> dfa);
+        for (i = patternPartCount() - 1; i >= 0; i--)
+          { search -> dfastate[i] = -1; }
+        i = 0;
+      }
+
     while (pattern && pattern[i])
       {
         cstring = NULL;
-        if (!getPatternSearchString(i, path, &cstring))
-          {
-            if (runtime -> searchtype == SEARCH_REGEX)
-              {   /* regular expression search */
-                cmp = regexec(&searchregex, cstring, 0, NULL, 0);
-              }
-            else
-              {   /* regular search */
-                if (runtime -> casesensitive)
-                  {   /* case sensitive comparison */
-                    cmp = strcmp(cstring, clisearchpattern);
-                  }
-                else
-                  {   /* case insensitive comparison */
-                    cmp = strcasecmp(cstring, clisearchpattern);
+        if (dfa)
+          {   /* all patterns of the path run through the same DFA */
+            cmp = !patternRegexMatch(i, path, search -> dfa,
+                search -> dfastate);
+            if (dfaCacheOverflow(search -> dfa))
+              {   /* the DFA grew too large, so the rest of the path is
+                   * searched with regexec()
+                   */
+                dfa = 0;
+                if (!search -> regexready)
+                  {
+                    search -> regexready =
+                        prepareSearchexpression(&search -> regex);
                   }
+                continue;
               }
+          }
+        else if (runtime -> searchtype == SEARCH_REGEX)
+          {   /* regular expression search in the terminal encoding */
+            if (search -> regexready &&
+                !getPatternSearchString(i, path, &cstring, search -> arena) &&
+                cstring)
+              { cmp = regexec(&search -> regex, cstring, 0, NULL, 0); }
+            else
+              { cmp = 1; }
+          }
+        else
+          {   /* literal search, compared without building the string */
+            cmp = !patternMatch(i, path, clisearchquery,
+                runtime -> searchtype, runtime -> casesensitive,
+                search -> arena);
+          }
 
-            if (!cmp)
-              {   /* we found a match! */
-                cresult = NULL;
-                if (!getPatternResultString(i, path, &cresult))
-                  {   /* and even have a result to display */
-                    lsize = listCount(searchresult);
-                    for (l = lexist = 0; l < lsize; l++)
-                      {
-                        if (!strcmp(searchresult[l], cresult))
-                          {   /* this result already exists, nothing to do */
-                            lexist = 1;
-                            break;
-                          }
-                      }
-
-                    if (!lexist)
-                      {   /* only if we don't know this result yet, we add it */
-                        searchresult = listAdd(searchresult, cresult);
-                        found++;
-                      }
-                  }
-                if (cresult)
-                  { memFreeString(__FILE__, __LINE__, cresult); }
+        if (!cmp)
+          {   /* we found a match! */
+            cresult = NULL;
+            if (!getPatternResultString(i, path, &cresult, search -> arena) &&
+                cresult)
+              {   /* and even have a result to display */
+                cliResultAdd(search, cresult);
               }
           }
-        if (cstring)
-          { memFreeString(__FILE__, __LINE__, cstring); }
+
+        /* the strings of this node are no longer needed */
+        memArenaReset(search -> arena);
 
         i++;
       }
 
-    return found;
+    /* regular expressions can't be ruled out by their fixed parts */
+    if (runtime -> searchtype == SEARCH_REGEX)
+      { return WALK_CONTINUE; }
+
+    for (i = 0; pattern && pattern[i]; i++)
+      {
+        if (!patternPrune(i, path, clisearchquery, runtime -> searchtype,
+            runtime -> casesensitive, search -> arena))
+          { return WALK_CONTINUE; }
+      }
+
+    return WALK_SKIP;
   }
 
 
@@ -402,10 +1037,10 @@ int cliTreeWalk(char** path)
  * Description    compile the regular expression for the search
  * Author         Harry Brueckner
  * Date           2005-08-05
- * Arguments      void
+ * Arguments      regex_t* regex  - the compiled expression
  * Return         1 if all is ok, otherwise 0 on error
  */
-int prepareSearchexpression(void)
+int prepareSearchexpression(regex_t* regex)
   {
     int                 eflags,
                         result;
@@ -413,8 +1048,8 @@ int prepareSearchexpression(void)
 
     TRACE(99, "prepareSearchexpression()", NULL);
 
-    if (runtime -> searchtype == SEARCH_REGULAR)
-      {   /* for the regular search we don't need anything */
+    if (runtime -> searchtype != SEARCH_REGEX)
+      {   /* for the literal searches we don't need anything */
         return 1;
       }
 
@@ -423,11 +1058,11 @@ int prepareSearchexpression(void)
     if (!runtime -> casesensitive)
       { eflags |= REG_ICASE; }
 
-    result = regcomp(&searchregex, clisearchpattern, eflags);
+    result = regcomp(regex, clisearchpattern, eflags);
     if (result)
       {
         errormsg = memAlloc(__FILE__, __LINE__, STDBUFFERLENGTH);
-        regerror(result, &searchregex, errormsg, STDBUFFERLENGTH);
+        regerror(result, regex, errormsg, STDBUFFERLENGTH);
         fprintf(stderr, "regular expression error: %s\n", errormsg);
         memFree(__FILE__, __LINE__, errormsg, STDBUFFERLENGTH);
       }
@@ -436,6 +1071,81 @@ int prepareSearchexpression(void)
   }
 
 
+#ifdef TEST_OPTION
+/* #############################################################################
+ *
+ * Description    compare the builtin regular expression engine with
+ *                regcomp() on the loaded database; every expression is
+ *                searched case sensitive and case insensitive with both
+ *                engines, which must find the same results
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         void
+ */
+void testRegex(void)
+  {
+    char**              expected;
+    int                 casesensitive,
+                        engine,
+                        error[2],
+                        i,
+                        id,
+                        ok = 1;
+
+    TRACE(99, "testRegex()", NULL);
+
+    runtime -> searchtype = SEARCH_REGEX;
+    for (i = 0; testregex[i]; i++)
+      {
+        for (casesensitive = 1; casesensitive >= 0; casesensitive--)
+          {
+            runtime -> casesensitive = casesensitive;
+            clisearchpattern = memAlloc(__FILE__, __LINE__,
+                strlen(testregex[i]) + 1);
+            strStrncpy(clisearchpattern, testregex[i],
+                strlen(testregex[i]) + 1);
+
+            expected = NULL;
+            for (engine = REGEX_POSIX; engine <= REGEX_BUILTIN; engine++)
+              {
+                config -> regexengine = engine;
+                error[engine] = cliSearchRun();
+
+                if (engine == REGEX_POSIX)
+                  {
+                    for (id = 0; id < cliworker[0].result -> count; id++)
+                      {
+                        expected = listAdd(expected,
+                            cliworker[0].result -> item[id]);
+                      }
+                    continue;
+                  }
+
+                /* both engines must find the same results */
+                if (error[REGEX_POSIX] != error[REGEX_BUILTIN] ||
+                    listCount(expected) != cliworker[0].result -> count)
+                  { ok = 0; }
+                for (id = 0; ok && id < cliworker[0].result -> count; id++)
+                  {
+                    if (strcmp(expected[id], cliworker[0].result -> item[id]))
+                      { ok = 0; }
+                  }
+              }
+
+            expected = listFree(expected);
+            memFreeString(__FILE__, __LINE__, clisearchpattern);
+            clisearchpattern = NULL;
+          }
+      }
+
+    cliSearchFree();
+
+    printf("regex %s\n", (ok) ? "ok" : "failed");
+  }
+#endif
+
+
 /* #############################################################################
  */
 
@@ -28,6 +28,7 @@
  * prototypes
  */
 int cliInterface(void);
+int cliSearch(void);
 
 
 #endif
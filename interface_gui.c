@@ -68,6 +68,7 @@ typedef struct sKeyEvent KEYEVENT;
 CDKSCREEN*              cdkscreen;
 WINDOW*                 curseswin;
 WINDOW*                 statusline = NULL;
+MEMARENA*               infoarena = NULL;     /* strings of the info box */
 
 
 /* #############################################################################
@@ -320,6 +321,9 @@ void destroyScreen(int line, char* message)
         cdkscreen = NULL;
       }
 
+    memArenaFree(infoarena);
+    infoarena = NULL;
+
     if (message)
       {
         fprintf(stderr, _("t-error: %s (%d)\n"), message, line);
@@ -547,7 +551,6 @@ int keyPreProcess(EObjectType cdktype, void* object, void* clientdata,
     KEYEVENT*           event = (KEYEVENT*)clientdata;
     int                 id,
                         nodes;
-    char**              nodenames;
 
     TRACE(99, "keyPreProcess()", NULL);
 
@@ -565,9 +568,7 @@ int keyPreProcess(EObjectType cdktype, void* object, void* clientdata,
             event -> preprocessdata, key);
       }
 
-    nodenames = xmlInterfaceGetNames();
-    nodes = listCount(nodenames);
-    xmlInterfaceFreeNames(nodenames);
+    nodes = xmlInterfaceCountNames();
 
     id = list -> scrollField -> currentItem;
     if (nodes == 0 ||
@@ -607,7 +608,7 @@ void freshAlphalist(CDKALPHALIST* widget)
 
     TRACE(99, "freshAlphalist()", NULL);
 
-    nodenames = xmlInterfaceGetNames();
+    nodenames = xmlInterfaceViewNames();
     nodes = listCount(nodenames);
 
     setCDKAlphalistContents(widget, nodenames, nodes);
@@ -617,8 +618,6 @@ void freshAlphalist(CDKALPHALIST* widget)
     setCDKAlphalistCurrentItem(widget, 0);
     drawCDKAlphalist(widget, BorderOf(widget));
 #endif
-
-    xmlInterfaceFreeNames(nodenames);
   }
 
 
@@ -1006,7 +1005,7 @@ int guiDialogEditComment(EObjectType cdktype, void* object, void* clientdata,
       }
 
     /* get the current comment */
-    comment = xmlInterfaceGetComment(label);
+    comment = xmlInterfaceGetComment(label, NULL);
 
     mentry = newCDKMentry(cdkscreen, CENTER, CENTER,
         _("</B>edit comment<!B>"),
@@ -1025,7 +1024,7 @@ int guiDialogEditComment(EObjectType cdktype, void* object, void* clientdata,
         runtime -> datachanged = 1;
 
         /* we update the infobox */
-        nodenames = xmlInterfaceGetNames();
+        nodenames = xmlInterfaceViewNames();
         id = 0;
         while (nodenames[id])
           {
@@ -1037,7 +1036,6 @@ int guiDialogEditComment(EObjectType cdktype, void* object, void* clientdata,
 
             id++;
           }
-        xmlInterfaceFreeNames(nodenames);
       }
     destroyCDKMentry(mentry);
 
@@ -1884,6 +1882,11 @@ int initializeScreen(void)
     /* clear the screen */
     eraseCDKScreen(cdkscreen);
 
+    /* the info box is updated with every cursor move, so its arena lives as
+     * long as the screen and is only reset after each update
+     */
+    infoarena = memArenaCreate(0);
+
     return 0;
   }
 
@@ -1918,15 +1921,16 @@ void guiUpdateInfo(CDKLABEL* infobox, char** infodata, int id)
         infodata[i][1] = 0;
       }
 
-    nodenames = xmlInterfaceGetNames();
-    nodes = listCount(nodenames);
+    nodenames = xmlInterfaceViewNames();
+    nodes = xmlInterfaceCountNames();
 
     if (nodes)
       {
-        comment = xmlInterfaceGetComment(nodenames[id]);
-        xmlInterfaceGetCreationLabel(nodenames[id], &created_by, &created_on);
+        comment = xmlInterfaceGetComment(nodenames[id], infoarena);
+        xmlInterfaceGetCreationLabel(nodenames[id], &created_by, &created_on,
+            infoarena);
         xmlInterfaceGetModificationLabel(nodenames[id], &modified_by,
-            &modified_on);
+            &modified_on, infoarena);
 
         if (modified_by && modified_on &&
             strcmp(modified_on, "---"))
@@ -1945,16 +1949,11 @@ void guiUpdateInfo(CDKLABEL* infobox, char** infodata, int id)
           }
 
         commentFormat(infodata, comment);
-
-        memFreeString(__FILE__, __LINE__, modified_by);
-        memFreeString(__FILE__, __LINE__, modified_on);
-        memFreeString(__FILE__, __LINE__, created_by);
-        memFreeString(__FILE__, __LINE__, created_on);
-        memFreeString(__FILE__, __LINE__, comment);
-
-        xmlInterfaceFreeNames(nodenames);
       }
 
+    /* all strings of this update are wiped */
+    memArenaReset(infoarena);
+
     setCDKLabelMessage(infobox, infodata, config -> infoheight);
     drawCDKLabel(infobox, FALSE);
   }
@@ -2041,7 +2040,7 @@ void interfaceLoop(void)
             title = getListtitle(level);
 
             /* get the names of the current nodes children */
-            nodenames = xmlInterfaceGetNames();
+            nodenames = xmlInterfaceViewNames();
             nodes = listCount(nodenames);
 
             listwidget[id] = newCDKAlphalist(cdkscreen, RIGHT, 0,
@@ -2059,7 +2058,6 @@ void interfaceLoop(void)
             if (!listwidget[id])
               { destroyScreen(__LINE__, _("can not create alpha list.")); }
 
-            xmlInterfaceFreeNames(nodenames);
             memFreeString(__FILE__, __LINE__, quicksearch);
             memFreeString(__FILE__, __LINE__, title);
           }
@@ -34,10 +34,16 @@
 #include "memory.h"
 
 
+/* #############################################################################
+ * internal functions
+ */
+int keyInsert(char* key);
+
+
 /* #############################################################################
  * global variables
  */
-char**                  encrypttionkeylist;
+LIST*                   encrypttionkeylist = NULL;
 
 
 /* #############################################################################
@@ -52,7 +58,7 @@ void freeKeys(void)
   {
     TRACE(99, "freeKeys()", NULL);
 
-    encrypttionkeylist = listFree(encrypttionkeylist);
+    encrypttionkeylist = listDestroy(encrypttionkeylist);
   }
 
 
@@ -68,7 +74,7 @@ void initKeys(void)
   {
     TRACE(99, "initKeys()", NULL);
 
-    encrypttionkeylist = NULL;
+    encrypttionkeylist = listCreate();
   }
 
 
@@ -82,32 +88,12 @@ void initKeys(void)
  */
 int keyAdd(char* key)
   {
-    char*               identifier;
-    char*               tname;
-
     TRACE(99, "keyAdd()", NULL);
 
-    if (!key || !strlen(key))
-      { return 0; }
-
-    tname = (char*)convert2xml(key);
-    identifier = gpgValidateEncryptionKey(tname);
+    /* the list changes, so keys imported in the meantime must be found */
+    gpgKeyCacheFlush();
 
-    if (identifier)
-      {
-        if (keyGetId(identifier) == -1)
-          {   /* we don't know this key yet */
-            encrypttionkeylist = listAdd(encrypttionkeylist, identifier);
-            listSort(encrypttionkeylist);
-          }
-
-        /* we must free the identifier string */
-        memFreeString(__FILE__, __LINE__, identifier);
-
-        return 1;
-      }
-    else
-      { return 0; }
+    return keyInsert(key);
   }
 
 
@@ -122,7 +108,6 @@ int keyAdd(char* key)
  */
 int keyChange(int id, char* key)
   {
-    int                 entries;
     char*               identifier;
     char*               tname;
 
@@ -131,12 +116,13 @@ int keyChange(int id, char* key)
     if (!key || !strlen(key))
       { return 0; }
 
-    entries = listCount(encrypttionkeylist);
-
     if (id < 0 ||
-        id >= entries)
+        id >= encrypttionkeylist -> count)
       { return 0; }
 
+    /* the list changes, so keys imported in the meantime must be found */
+    gpgKeyCacheFlush();
+
     tname = (char*)convert2xml(key);
     identifier = gpgValidateEncryptionKey(tname);
     if (identifier)
@@ -147,9 +133,9 @@ int keyChange(int id, char* key)
           }
         else
           {   /* we don't know this key */
-            memFreeString(__FILE__, __LINE__, encrypttionkeylist[id]);
-            encrypttionkeylist[id] = identifier;
-            listSort(encrypttionkeylist);
+            memFreeString(__FILE__, __LINE__, encrypttionkeylist -> item[id]);
+            encrypttionkeylist -> item[id] = identifier;
+            listSort(encrypttionkeylist -> item);
           }
 
         return 1;
@@ -171,7 +157,7 @@ int keyCount(void)
   {
     TRACE(99, "keyCount()", NULL);
 
-    return listCount(encrypttionkeylist);
+    return encrypttionkeylist -> count;
   }
 
 
@@ -185,13 +171,25 @@ int keyCount(void)
  */
 void keyDefaults(void)
   {
-    int                 i;
+    MEMARENA*           arena;
+    int                 count,
+                        i;
+    char**              keynames;
 
     TRACE(99, "keyDefaults()", NULL);
 
-    for (i = listCount(config -> defaultkeys); i > 0; i--)
+    /* we list all keys at once instead of one after the other */
+    count = listCount(config -> defaultkeys);
+    arena = memArenaCreate(0);
+    keynames = memArenaAlloc(arena, (count + 1) * sizeof(char*));
+    for (i = 0; i < count; i++)
+      { keynames[i] = convertArena(0, config -> defaultkeys[i], arena); }
+    gpgKeyCachePrefetch(keynames, count);
+    memArenaFree(arena);
+
+    for (i = count; i > 0; i--)
       {
-        if (!keyAdd(config -> defaultkeys[i - 1]))
+        if (!keyInsert(config -> defaultkeys[i - 1]))
           {
             fprintf(stderr,
                 _("error: encryption key %s could not be validated; not using it.\n"),
@@ -213,7 +211,8 @@ void keyDelete(int id)
   {
     TRACE(99, "keyDelete()", NULL);
 
-    encrypttionkeylist = listDelete(encrypttionkeylist, id);
+    listRemove(encrypttionkeylist, id);
+    gpgKeyCacheFlush();
   }
 
 
@@ -229,7 +228,7 @@ char* keyGet(int id)
   {
     TRACE(99, "keyGet()", NULL);
 
-    return encrypttionkeylist[id];
+    return encrypttionkeylist -> item[id];
   }
 
 
@@ -247,9 +246,9 @@ int keyGetId(char* key)
 
     TRACE(99, "keyGetId()", NULL);
 
-    for (i = listCount(encrypttionkeylist); i > 0; i--)
+    for (i = encrypttionkeylist -> count; i > 0; i--)
       {
-        if (!strcmp(encrypttionkeylist[i - 1], key))
+        if (!strcmp(encrypttionkeylist -> item[i - 1], key))
             return i - 1;
       }
 
@@ -269,7 +268,46 @@ char** keyGetList(int id)
   {
     TRACE(99, "keyGetList()", NULL);
 
-    return encrypttionkeylist;
+    return encrypttionkeylist -> item;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    add a key without flushing the key cache
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      char* key   - the key to add
+ * Return         int 1 if the key was added, otherwise 0
+ */
+int keyInsert(char* key)
+  {
+    char*               identifier;
+    char*               tname;
+
+    TRACE(99, "keyInsert()", NULL);
+
+    if (!key || !strlen(key))
+      { return 0; }
+
+    tname = (char*)convert2xml(key);
+    identifier = gpgValidateEncryptionKey(tname);
+
+    if (identifier)
+      {
+        if (keyGetId(identifier) == -1)
+          {   /* we don't know this key yet */
+            listAppend(encrypttionkeylist, identifier);
+            listSort(encrypttionkeylist -> item);
+          }
+
+        /* we must free the identifier string */
+        memFreeString(__FILE__, __LINE__, identifier);
+
+        return 1;
+      }
+    else
+      { return 0; }
   }
 
 
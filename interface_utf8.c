@@ -25,23 +25,43 @@
  * includes
  */
 #include "cpm.h"
+#ifdef HAVE_LIBPTHREAD
+  #include <pthread.h>
+#endif
 #include "general.h"
 #include "interface_utf8.h"
 #include "memory.h"
 #include "string.h"
 
 
+/* #############################################################################
+ * internal functions
+ */
+int convertIsAscii(const char* string, int* size);
+int convertString(int direction, char* instring, int insize, char* outstring,
+    int* outsize);
+
+
 /* #############################################################################
  * global variables
  */
+#define ASCII_ONES      ((size_t)-1 / 0xFF)
+#define ASCII_HIGHS     (ASCII_ONES * 0x80)
+
 xmlCharEncodingHandler* encodingHandler = NULL;
 char*                   convertbuffer = NULL;
+int                     convertbuffersize = 0;
+int                     convertascii = 0;
+#ifdef HAVE_LIBPTHREAD
+pthread_mutex_t         convertlock = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 
 /* #############################################################################
  *
  * Description    convert the given string to the terminal display type (latin1)
- *                or UTF-8
+ *                or UTF-8; the result is only valid until the next call and
+ *                may be the input string itself if it needs no conversion
  * Author         Harry Brueckner
  * Date           2005-07-03
  * Arguments      int direction   - 0 for input (to UTF-8),
@@ -51,10 +71,7 @@ char*                   convertbuffer = NULL;
  */
 char* convert(int direction, char* instring)
   {
-    int                 insize,
-                        outsize,
-                        ret,
-                        tmp;
+    int                 size;
 
     TRACE(199, "convert()", NULL);
 
@@ -62,51 +79,214 @@ char* convert(int direction, char* instring)
         return NULL;
     if (!encodingHandler || !encodingHandler->output)
        return instring; // NULL handler, return instring
+    if (convertascii && convertIsAscii(instring, &size))
+      { return instring; }
+
+    size = (strlen(instring) + 1) * 2 - 1;
+    if (size > convertbuffersize)
+      {   /* the buffer only grows, so most calls don't allocate at all */
+        if (convertbuffer)
+          { memFree(__FILE__, __LINE__, convertbuffer, convertbuffersize); }
+        convertbuffersize = size;
+        convertbuffer = memAlloc(__FILE__, __LINE__, convertbuffersize);
+      }
 
-    if (convertbuffer)
+    return convertBuffer(direction, instring, convertbuffer,
+        convertbuffersize);
+  }
+
+
+/* #############################################################################
+ *
+ * Description    convert the given string like convert() does, but into
+ *                memory of the given arena; no global buffer is used, so
+ *                threads with their own arena can convert at the same time
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      int direction   - 0 for input (to UTF-8),
+ *                                  1 for output direction
+ *                char* instring  - string to convert
+ *                MEMARENA* arena - arena for the converted string
+ * Return         converted string
+ */
+char* convertArena(int direction, char* instring, MEMARENA* arena)
+  {
+    int                 size;
+
+    TRACE(199, "convertArena()", NULL);
+
+    if (!instring)
+      { return NULL; }
+    if (!encodingHandler ||
+        !encodingHandler -> output)
+      {   /* without a handler the string is used as it is */
+        return instring;
+      }
+    if (convertascii && convertIsAscii(instring, &size))
+      { return instring; }
+
+    size = (strlen(instring) + 1) * 2 - 1;
+
+    return convertBuffer(direction, instring, memArenaAlloc(arena, size),
+        size);
+  }
+
+
+/* #############################################################################
+ *
+ * Description    convert the given string into a buffer of the caller;
+ *                strings which need no conversion are returned unchanged
+ *                without touching the buffer
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      int direction   - 0 for input (to UTF-8),
+ *                                  1 for output direction
+ *                char* instring  - string to convert
+ *                char* buffer    - buffer for the result
+ *                int size        - size of the buffer, it must hold twice
+ *                                  the length of the string plus one
+ * Return         the converted string, the input string or NULL if the
+ *                conversion failed or the buffer is too small
+ */
+char* convertBuffer(int direction, char* instring, char* buffer, int size)
+  {
+    int                 insize,
+                        outsize;
+
+    TRACE(199, "convertBuffer()", NULL);
+
+    if (!instring)
+      { return NULL; }
+    if (!encodingHandler ||
+        !encodingHandler -> output)
+      {   /* without a handler the string is used as it is */
+        return instring;
+      }
+    if (convertascii && convertIsAscii(instring, &insize))
+      { return instring; }
+
+    insize = strlen(instring) + 1;
+    outsize = size - 1;
+    if (size < insize * 2 - 1 ||
+        convertString(direction, instring, insize, buffer, &outsize))
+      { return NULL; }
+    buffer[outsize] = 0;
+
+    return buffer;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    check if a string is plain 7-bit ASCII; the string is
+ *                scanned a machine word at a time, the reads are aligned so
+ *                they never cross into the next page
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      const char* string  - string to check
+ *                int* size           - returns the length of the string
+ * Return         int 1 if the string is ASCII, otherwise 0
+ */
+int convertIsAscii(const char* string, int* size)
+  {
+    const char*         ptr = string;
+    size_t              word;
+
+    TRACE(199, "convertIsAscii()", NULL);
+
+    while ((size_t)ptr % sizeof(size_t))
+      {   /* the unaligned head */
+        if (!*ptr)
+          {
+            *size = ptr - string;
+            return 1;
+          }
+        if (*ptr & 0x80)
+          { return 0; }
+        ptr++;
+      }
+
+    while (1)
       {
-        memFreeString(__FILE__, __LINE__, convertbuffer);
-        convertbuffer = NULL;
+        memcpy(&word, ptr, sizeof(size_t));
+        if ((word - ASCII_ONES) & ~word & ASCII_HIGHS)
+          { break; }    /* the word holds the terminating 0 */
+        if (word & ASCII_HIGHS)
+          { return 0; }
+        ptr += sizeof(size_t);
+      }
+
+    while (*ptr)
+      {   /* the tail */
+        if (*ptr & 0x80)
+          { return 0; }
+        ptr++;
       }
 
-    insize = strlen((char*)instring) + 1;
-    outsize = insize * 2 - 1;
-    convertbuffer = memAlloc(__FILE__, __LINE__, outsize);
+    *size = ptr - string;
+    return 1;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    convert a string into the given buffer; an encoding
+ *                handler may keep state between calls (iconv and ICU do),
+ *                so only one thread at a time uses it
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      int direction     - 0 for input (to UTF-8),
+ *                                    1 for output direction
+ *                char* instring    - string to convert
+ *                int insize        - size of the string including the 0
+ *                char* outstring   - buffer for the result
+ *                int* outsize      - size of the buffer; it returns the
+ *                                    length of the result
+ * Return         int 1 if the conversion failed, otherwise 0
+ */
+int convertString(int direction, char* instring, int insize, char* outstring,
+    int* outsize)
+  {
+    int                 ret,
+                        tmp;
+
+    TRACE(199, "convertString()", NULL);
+
     // (xml)encodingHandler doesn't handle empty strings
     if(insize == 1){
-       convertbuffer[0] = '\0';
-       return convertbuffer;
+       outstring[0] = '\0';
+       *outsize = 0;
+       return 0;
     }
 
     tmp = insize - 1;
+#ifdef HAVE_LIBPTHREAD
+    pthread_mutex_lock(&convertlock);
+#endif
     if (direction)
       {
         ret = encodingHandler -> output(
-            (unsigned char*)convertbuffer, &outsize,
+            (unsigned char*)outstring, outsize,
             (unsigned char*)instring, &tmp);
       }
     else
       {
         ret = encodingHandler -> input(
-            (unsigned char*)convertbuffer, &outsize,
+            (unsigned char*)outstring, outsize,
             (unsigned char*)instring, &tmp);
       }
+#ifdef HAVE_LIBPTHREAD
+    pthread_mutex_unlock(&convertlock);
+#endif
     if (ret <= 0 || tmp != insize - 1)
       {
         fprintf(stderr, _("conversion failed for string '%s' (%d).\n"),
             instring,
             ret);
-        memFree(__FILE__, __LINE__, convertbuffer, outsize);
-        return NULL;
-      }
-    else
-      {
-        convertbuffer = memRealloc(__FILE__, __LINE__,
-            convertbuffer, insize * 2 - 1, outsize + 1);
-        convertbuffer[outsize] = 0;
+        return 1;
       }
 
-    return convertbuffer;
+    return 0;
   }
 
 
@@ -154,8 +334,9 @@ void freeUTF8Interface(void)
 
     if (convertbuffer)
       {
-        memFreeString(__FILE__, __LINE__, convertbuffer);
+        memFree(__FILE__, __LINE__, convertbuffer, convertbuffersize);
         convertbuffer = NULL;
+        convertbuffersize = 0;
       }
 
     if (encodingHandler)
@@ -175,7 +356,9 @@ void freeUTF8Interface(void)
 int initUTF8Encoding(char* encoding)
   {
     xmlCharEncoding     encoder;
-    int                 status = 0;
+    int                 i,
+                        status = 0;
+    char                ascii[128];
     char*               tmp;
     char*               tstring1 = NULL;
     char*               tstring2 = NULL;
@@ -202,6 +385,19 @@ int initUTF8Encoding(char* encoding)
         }
     }
 
+    /* ASCII compatible encodings let us skip converting 7-bit strings */
+    for (i = 1; i < 128; i++)
+      { ascii[i - 1] = i; }
+    ascii[127] = 0;
+    convertascii = 0;
+    tmp = convert(0, ascii);
+    if (tmp && !strcmp(tmp, ascii))
+      {
+        tmp = convert(1, ascii);
+        if (tmp && !strcmp(tmp, ascii))
+          { convertascii = 1; }
+      }
+
     tmp = convert(0, TSTRING);
     if (tmp)
       {   /* converting to UTF-8 was successful */
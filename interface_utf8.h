@@ -34,6 +34,7 @@
   #include <libxml/tree.h>
   #include <libxml/xpath.h>
 #endif
+#include "memory.h"
 
 
 /* #############################################################################
@@ -41,6 +42,8 @@
  */
 
 char* convert(int direction, char* instring);
+char* convertArena(int direction, char* instring, MEMARENA* arena);
+char* convertBuffer(int direction, char* instring, char* buffer, int size);
 char* convert2terminal(xmlChar* instring);
 xmlChar* convert2xml(char* instring);
 void freeUTF8Interface(void);
@@ -25,6 +25,7 @@
  * includes
  */
 #include "cpm.h"
+#include <assert.h>
 #include <pwd.h>
 #include <time.h>
 #include "configuration.h"
@@ -39,28 +40,145 @@
 
 
 /* #############################################################################
- * internal functions
+ * global variables
  */
-void createEditorsNode(void);
-void createTemplateNode(void);
-int editorAdd(xmlChar* editor);
-char* editorFindById(int uid);
-int editorFindByName(char* editor);
-static int nodeSort(const void* node1, const void* node2);
-xmlNode* nodeFind(char* label);
+#define NODEINDEX_MINSIZE   16
 
+typedef struct sNodeIndexEntry NODEINDEXENTRY;
+struct sNodeIndexEntry
+  {
+    NODEINDEXENTRY*     next;
+    xmlNode*            node;
+    char*               label;
+    unsigned int        hash;
+  };
+
+typedef struct sNodeIndex NODEINDEX;
+struct sNodeIndex
+  {
+    NODEINDEX*          prev;         /* list of all indices */
+    NODEINDEX*          next;
+    xmlNode*            parent;
+    NODEINDEXENTRY**    bucket;
+    char**              names;
+    int                 count,
+                        generation,
+                        namegeneration,
+                        namesize,
+                        size;
+  };
+
+#define EDITOR_MINSIZE      16
+#define NODETIME_NONE       0
+#define NODETIME_PARSED     1
+#define NODETIME_RAW        2
+
+typedef struct sEditorEntry EDITORENTRY;
+struct sEditorEntry
+  {
+    EDITORENTRY*        nextbyid;
+    EDITORENTRY*        nextbyname;
+    char*               name;
+    unsigned int        hash;
+    int                 uid;
+  };
+
+typedef struct sNodeTime NODETIME;
+struct sNodeTime
+  {
+    short               year;
+    char                month,
+                        day,
+                        hour,
+                        minute,
+                        second,
+                        state;
+  };
+
+#define WALKPATH_MINSIZE    16
+#ifdef TEST_OPTION
+  #define TREEWALK_DEPTH    50000
+#endif
+
+typedef struct sNodeInfo NODEINFO;
+struct sNodeInfo
+  {
+    NODETIME            created_on,
+                        modified_on;
+    char*               folded;       /* case folded label */
+    char*               terminal;     /* label in the terminal encoding */
+    char*               comment;      /* comment in the terminal encoding,
+                                       * empty if it was removed */
+    NODEINDEX*          index;        /* label index of the children */
+    int                 created_by,
+                        modified_by,
+                        shadowed,
+                        commentsize,  /* size of the memory of comment */
+                        terminalsize, /* size of the memory of terminal */
+                        valid;
+  };
 
-/* #############################################################################
- * global variables
- */
 xmlNode**               xmlwalklist;
+NODEINDEX*              xmlindexlist;
+MEMARENA*               nodeinfoarena;
+WALKPATH                walkpath;
+EDITORENTRY**           editorbyid;
+EDITORENTRY**           editorbyname;
+int                     editorcount = 0,
+                        editorsize = 0;
 xmlNode*                editorsnode;
 xmlNode*                templatenode;
-int                     level = 0,
+int                     labelsfolded = 0,
+                        labelsshadowed = 0,
+                        level = 0,
                         maxeditor = 0,
                         maxlevel = 0;
 /* Flawfinder: ignore */
 char                    staticlabel[128];
+#ifdef TEST_OPTION
+  int                   testwalkdepth,
+                        testwalknodes;
+  char*                 testwalklabel;
+#endif
+
+
+/* #############################################################################
+ * internal functions
+ */
+void createEditorsNode(void);
+void createTemplateNode(void);
+int editorAdd(xmlChar* editor);
+char* editorFindById(int uid, MEMARENA* arena);
+int editorFindByName(char* editor);
+void editorRegister(char* name, int uid);
+void editorRegistryFree(void);
+void editorRegistryResize(int size);
+int foldVisit(WALKPATH* path);
+static int nodeSort(const void* node1, const void* node2);
+xmlNode* nodeFind(char* label);
+void nodeIndexAdd(NODEINDEX* index, xmlNode* node, int ordered);
+void nodeIndexDrop(xmlNode* node);
+void nodeIndexFree(NODEINDEX* index);
+NODEINDEX* nodeIndexGet(void);
+char** nodeIndexNames(NODEINDEX* index);
+void nodeIndexRemove(NODEINDEX* index, xmlNode* node);
+void nodeIndexResize(NODEINDEX* index, int size);
+NODEINFO* nodeInfoAttach(xmlNode* node);
+NODEINFO* nodeInfoGet(xmlNode* node);
+int nodeInfoParseId(xmlNode* node, const char* name);
+void nodeInfoParseTime(xmlNode* node, const char* name, NODETIME* ntime);
+NODEINFO* nodeInfoShadow(xmlNode* node);
+char* nodeInfoStore(char* slot, int* size, const char* string);
+char* nodeInfoTimeString(xmlNode* node, const char* name, NODETIME* ntime,
+    MEMARENA* arena);
+char* nodeLabel(xmlNode* node, WALKPATH* path);
+int shadowVisit(WALKPATH* path);
+char* stringCopy(MEMARENA* arena, const char* string);
+#ifdef TEST_OPTION
+  int testTreeWalkVisit(WALKPATH* path);
+  int testTreeWalkSkip(WALKPATH* path);
+#endif
+int treeWalk(xmlNode* node, int single, WALKFN visitor, WALKPATH* path);
 
 
 /* #############################################################################
@@ -75,7 +193,10 @@ void createEditorsNode(void)
   {
     xmlNode*            curnode;
     xmlNode*            rootnode;
+    int                 created = 0,
+                        uid;
     char*               prop;
+    char*               user;
 
     TRACE(99, "createEditorsNode()", NULL);
 
@@ -110,10 +231,12 @@ void createEditorsNode(void)
           }
 
         xmlSetCreation(editorsnode);
-        editorAdd(convert2xml("unknown"));
+        created = 1;
       }
 
-    /* we find the current maximum for uid */
+    /* we register all users and find the current maximum for uid */
+    editorRegistryFree();
+    editorRegistryResize(EDITOR_MINSIZE);
     maxeditor = 0;
     curnode = editorsnode -> children;
     while (curnode)
@@ -125,12 +248,20 @@ void createEditorsNode(void)
             if (prop)
               {   /* we found a user */
                 /* Flawfinder: ignore */
-                maxeditor = max(maxeditor, atoi(prop));
+                uid = atoi(prop);
+                maxeditor = max(maxeditor, uid);
+
+                user = convert2terminal(xmlNodeGetContent(curnode));
+                if (user)
+                  { editorRegister(user, uid); }
               }
           }
 
         curnode = curnode -> next;
       }
+
+    if (created)
+      { editorAdd(convert2xml("unknown")); }
   }
 
 
@@ -196,7 +327,9 @@ void createTemplateNode(void)
 int editorAdd(xmlChar* editor)
   {
     xmlNode*            curnode;
+    xmlChar*            content;
     int                 curuid;
+    char*               user;
     /* Flawfinder: ignore */
     char                uid[10];
 
@@ -223,6 +356,14 @@ int editorAdd(xmlChar* editor)
     xmlNewProp(curnode, BAD_CAST "uid", convert2xml(uid));
     xmlSetCreation(curnode);
 
+    /* we register the name as it is read back from the document */
+    content = xmlNodeGetContent(curnode);
+    user = convert2terminal(content);
+    if (user)
+      { editorRegister(user, maxeditor); }
+    if (content)
+      { xmlFree(content); }
+
     return maxeditor;
   }
 
@@ -232,15 +373,13 @@ int editorAdd(xmlChar* editor)
  * Description    find an editor by his user id
  * Author         Harry Brueckner
  * Date           2005-04-06
- * Arguments      int uid   - user id of the editor
+ * Arguments      int uid           - user id of the editor
+ *                MEMARENA* arena   - arena for the result or NULL
  * Return         char* name of the editor
  */
-char* editorFindById(int uid)
+char* editorFindById(int uid, MEMARENA* arena)
   {
-    xmlNode*            curnode;
-    char*               prop;
-    char*               result;
-    char*               user;
+    EDITORENTRY*        entry;
 
     TRACE(99, "editorFindById()", NULL);
 
@@ -250,184 +389,1360 @@ char* editorFindById(int uid)
     if (uid < 1 || uid > maxeditor)
       { return NULL; }
 
-    curnode = editorsnode -> children;
-    while (curnode)
+    entry = editorbyid[(unsigned int)uid & (editorsize - 1)];
+    while (entry)
       {
-        if (curnode -> type == XML_ELEMENT_NODE &&
-            !strcmp((char*)curnode -> name, "user"))
+        if (entry -> uid == uid)
+          { return stringCopy(arena, entry -> name); }
+
+        entry = entry -> nextbyid;
+      }
+
+    return NULL;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    find an editor by his name
+ * Author         Harry Brueckner
+ * Date           2005-04-06
+ * Arguments      char* editor  - name of the editor
+ * Return         int user id of the editor
+ */
+int editorFindByName(char* editor)
+  {
+    EDITORENTRY*        entry;
+    unsigned int        hash;
+
+    TRACE(99, "editorFindByName()", NULL);
+
+    if (!editorsnode)
+      { createEditorsNode(); }
+
+    if (!editor)
+      { return editorFindByName("unknown"); }
+
+    hash = strHash(editor);
+    entry = editorbyname[hash & (editorsize - 1)];
+    while (entry)
+      {
+        if (entry -> hash == hash &&
+            !strcmp(entry -> name, editor))
+          {   /* we found the user */
+            if (entry -> uid > 0)
+              { return entry -> uid; }
+            else
+              { return -1; }
+          }
+
+        entry = entry -> nextbyname;
+      }
+
+    return -1;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    add a user to the editor registry; both lookups keep the
+ *                document order so the first user with a name or uid is
+ *                found as before
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      char* name  - name of the user in terminal encoding
+ *                int uid     - uid of the user
+ * Return         void
+ */
+void editorRegister(char* name, int uid)
+  {
+    EDITORENTRY*        entry;
+    EDITORENTRY**       tail;
+
+    TRACE(99, "editorRegister()", NULL);
+
+    if (editorcount >= editorsize)
+      { editorRegistryResize(editorsize * 2); }
+
+    entry = memAlloc(__FILE__, __LINE__, sizeof(EDITORENTRY));
+    entry -> nextbyid = NULL;
+    entry -> nextbyname = NULL;
+    entry -> name = stringCopy(NULL, name);
+    entry -> hash = strHash(name);
+    entry -> uid = uid;
+
+    tail = &editorbyid[(unsigned int)uid & (editorsize - 1)];
+    while (*tail)
+      { tail = &(*tail) -> nextbyid; }
+    *tail = entry;
+
+    tail = &editorbyname[entry -> hash & (editorsize - 1)];
+    while (*tail)
+      { tail = &(*tail) -> nextbyname; }
+    *tail = entry;
+
+    editorcount++;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    free the editor registry
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         void
+ */
+void editorRegistryFree(void)
+  {
+    EDITORENTRY*        entry;
+    EDITORENTRY*        next;
+    int                 i;
+
+    TRACE(99, "editorRegistryFree()", NULL);
+
+    if (!editorbyname)
+      { return; }
+
+    for (i = 0; i < editorsize; i++)
+      {
+        entry = editorbyname[i];
+        while (entry)
           {
-            prop = convert2terminal(xmlGetProp(curnode, BAD_CAST "uid"));
-            if (prop)
-              {   /* we found a user */
-                /* Flawfinder: ignore */
-                if (uid == atoi(prop))
-                  {
-                    user = convert2terminal(xmlNodeGetContent(curnode));
-                    result = memAlloc(__FILE__, __LINE__, strlen(user) + 1);
-                    strStrncpy(result, user, strlen(user) + 1);
-
-                    return result;
-                  }
-              }
+            next = entry -> nextbyname;
+            memFreeString(__FILE__, __LINE__, entry -> name);
+            memFree(__FILE__, __LINE__, entry, sizeof(EDITORENTRY));
+            entry = next;
           }
+      }
 
-        curnode = curnode -> next;
+    memFree(__FILE__, __LINE__, editorbyid,
+        editorsize * sizeof(EDITORENTRY*));
+    memFree(__FILE__, __LINE__, editorbyname,
+        editorsize * sizeof(EDITORENTRY*));
+
+    editorbyid = NULL;
+    editorbyname = NULL;
+    editorcount = 0;
+    editorsize = 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    resize the hash tables of the editor registry
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      int size  - new number of buckets, a power of 2
+ * Return         void
+ */
+void editorRegistryResize(int size)
+  {
+    EDITORENTRY**       byid;
+    EDITORENTRY**       byname;
+    EDITORENTRY**       tail;
+    EDITORENTRY*        entry;
+    EDITORENTRY*        next;
+    int                 i;
+
+    TRACE(99, "editorRegistryResize()", NULL);
+
+    byid = memAlloc(__FILE__, __LINE__, size * sizeof(EDITORENTRY*));
+    byname = memAlloc(__FILE__, __LINE__, size * sizeof(EDITORENTRY*));
+    for (i = 0; i < size; i++)
+      {
+        byid[i] = NULL;
+        byname[i] = NULL;
+      }
+
+    /* we collect the entries in the order of the old id chains */
+    for (i = 0; i < editorsize; i++)
+      {
+        entry = editorbyid[i];
+        while (entry)
+          {
+            next = entry -> nextbyid;
+            entry -> nextbyid = NULL;
+
+            tail = &byid[(unsigned int)entry -> uid & (size - 1)];
+            while (*tail)
+              { tail = &(*tail) -> nextbyid; }
+            *tail = entry;
+
+            entry = next;
+          }
+      }
+    for (i = 0; i < editorsize; i++)
+      {
+        entry = editorbyname[i];
+        while (entry)
+          {
+            next = entry -> nextbyname;
+            entry -> nextbyname = NULL;
+
+            tail = &byname[entry -> hash & (size - 1)];
+            while (*tail)
+              { tail = &(*tail) -> nextbyname; }
+            *tail = entry;
+
+            entry = next;
+          }
+      }
+
+    if (editorsize)
+      {
+        memFree(__FILE__, __LINE__, editorbyid,
+            editorsize * sizeof(EDITORENTRY*));
+        memFree(__FILE__, __LINE__, editorbyname,
+            editorsize * sizeof(EDITORENTRY*));
+      }
+
+    editorbyid = byid;
+    editorbyname = byname;
+    editorsize = size;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    callback function for xml tree walking which attaches the
+ *                case folded label to every node; labels which don't change
+ *                are borrowed from the document
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      WALKPATH* path  - path we are currently at
+ * Return         int WALK_CONTINUE
+ */
+int foldVisit(WALKPATH* path)
+  {
+    NODEINFO*           info;
+    xmlAttr*            attr;
+    xmlNode*            node = path -> node[path -> depth - 1];
+    /* Flawfinder: ignore */
+    char                buffer[STDSTRINGLENGTH];
+    char*               label = path -> label[path -> depth - 1];
+    int                 borrowed;
+
+    TRACE(99, "foldVisit()", NULL);
+
+    info = nodeInfoAttach(node);
+    if (strlen(label) >= STDSTRINGLENGTH)
+      {
+        info -> folded = memArenaAlloc(nodeinfoarena, strlen(label) + 1);
+        strFold(info -> folded, label);
+        return WALK_CONTINUE;
+      }
+
+    attr = xmlHasProp(node, BAD_CAST "label");
+    borrowed = (attr -> children &&
+        label == (char*)attr -> children -> content);
+
+    if (strFold(buffer, label) ||
+        !borrowed)
+      { info -> folded = memArenaString(nodeinfoarena, buffer); }
+    else
+      { info -> folded = label; }
+
+    return WALK_CONTINUE;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    free the XML parser stuff
+ * Author         Harry Brueckner
+ * Date           2005-03-18
+ * Arguments      void
+ * Return         void
+ */
+void freeXMLInterface(void)
+  {
+    TRACE(99, "freeXMLInterface()", NULL);
+
+    editorRegistryFree();
+
+    /* freeing an index clears it in the node data, so the indices go first */
+    while (xmlindexlist)
+      { nodeIndexFree(xmlindexlist); }
+
+    if (nodeinfoarena)
+      {
+        memArenaFree(nodeinfoarena);
+        nodeinfoarena = NULL;
+      }
+    labelsfolded = 0;
+    labelsshadowed = 0;
+
+    xmlInterfaceWalkPathFree(&walkpath);
+
+    if (xmlwalklist)
+      {
+        memFree(__FILE__, __LINE__, xmlwalklist, maxlevel * sizeof(xmlNode*));
+        xmlwalklist = NULL;
+      }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    initialize the XML parser
+ * Author         Harry Brueckner
+ * Date           2005-03-18
+ * Arguments      void
+ * Return         void
+ */
+void initXMLInterface(void)
+  {
+    TRACE(99, "initXMLInterface()", NULL);
+
+    level = 0;
+    maxlevel = 0;
+
+    editorsnode = NULL;
+    editorbyid = NULL;
+    editorbyname = NULL;
+    templatenode = NULL;
+    nodeinfoarena = NULL;
+    xmlInterfaceWalkPathInit(&walkpath);
+    xmlindexlist = NULL;
+    xmlwalklist = NULL;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    see if a node witht the passed label exists in the current
+ *                node; the lookup is done in the hash index of the current
+ *                level which is built on first use
+ * Author         Harry Brueckner
+ * Date           2005-03-29
+ * Arguments      char* label - label of the node to find
+ * Return         xmlNode* pointing to the found node
+ */
+xmlNode* nodeFind(char* label)
+  {
+    NODEINDEX*          index;
+    NODEINDEXENTRY*     entry;
+    unsigned int        hash;
+
+    TRACE(99, "nodeFind()", NULL);
+
+    if (!level || !label)
+      { return 0; }
+
+    index = nodeIndexGet();
+    hash = strHash(label);
+
+    entry = index -> bucket[hash & (index -> size - 1)];
+    while (entry)
+      {
+        if (entry -> hash == hash &&
+            !strcmp(label, entry -> label))
+          {   /* we found the label */
+            return entry -> node;
+          }
+
+        entry = entry -> next;
+      }
+
+    return NULL;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    add a node to a label index; nodes with a label which can
+ *                not be converted are skipped since they can't be found
+ *                anyway
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      NODEINDEX* index  - index to add the node to
+ *                xmlNode* node     - the node to add
+ *                int ordered       - 1 if the node may be in front of nodes
+ *                                    which already are in the index
+ * Return         void
+ */
+void nodeIndexAdd(NODEINDEX* index, xmlNode* node, int ordered)
+  {
+    NODEINDEXENTRY*     entry;
+    NODEINDEXENTRY**    tail;
+    xmlNode*            sibling;
+    char*               label;
+
+    TRACE(99, "nodeIndexAdd()", NULL);
+
+    label = nodeInfoShadow(node) -> terminal;
+    if (!label)
+      { return; }
+
+    entry = memAlloc(__FILE__, __LINE__, sizeof(NODEINDEXENTRY));
+    entry -> next = NULL;
+    entry -> node = node;
+    entry -> label = stringCopy(NULL, label);
+    entry -> hash = strHash(entry -> label);
+
+    if (index -> count >= index -> size)
+      { nodeIndexResize(index, index -> size * 2); }
+
+    /* the chain keeps the document order of equal labels, so nodeFind()
+     * finds the same node as a walk through the children
+     */
+    tail = &index -> bucket[entry -> hash & (index -> size - 1)];
+    while (*tail)
+      {
+        if (ordered &&
+            (*tail) -> hash == entry -> hash &&
+            !strcmp((*tail) -> label, entry -> label))
+          {   /* an equal label which follows the node goes behind it */
+            sibling = node -> next;
+            while (sibling &&
+                sibling != (*tail) -> node)
+              { sibling = sibling -> next; }
+            if (sibling)
+              { break; }
+          }
+
+        tail = &(*tail) -> next;
       }
+    entry -> next = *tail;
+    *tail = entry;
+
+    index -> count++;
+    index -> generation++;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    free the label indices of a node and all nodes below it;
+ *                the subtree is walked without recursion, so deep trees
+ *                can't exhaust the stack
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      xmlNode* node - the node to free the indices of
+ * Return         void
+ */
+void nodeIndexDrop(xmlNode* node)
+  {
+    xmlNode*            curnode = node;
+    NODEINFO*           info;
+
+    TRACE(99, "nodeIndexDrop()", NULL);
+
+    while (curnode)
+      {
+        info = curnode -> _private;
+        if (curnode -> type == XML_ELEMENT_NODE &&
+            info &&
+            info -> index)
+          { nodeIndexFree(info -> index); }
+
+        if (curnode -> children)
+          {
+            curnode = curnode -> children;
+            continue;
+          }
+
+        while (curnode != node &&
+            !curnode -> next)
+          { curnode = curnode -> parent; }
+        if (curnode == node)
+          { break; }
+
+        curnode = curnode -> next;
+      }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    free a label index and detach it from its node
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      NODEINDEX* index  - the index to free
+ * Return         void
+ */
+void nodeIndexFree(NODEINDEX* index)
+  {
+    NODEINDEXENTRY*     entry;
+    NODEINDEXENTRY*     next;
+    int                 i;
+
+    TRACE(99, "nodeIndexFree()", NULL);
+
+    if (!index)
+      { return; }
+
+    if (index -> prev)
+      { index -> prev -> next = index -> next; }
+    else
+      { xmlindexlist = index -> next; }
+    if (index -> next)
+      { index -> next -> prev = index -> prev; }
+
+    ((NODEINFO*)index -> parent -> _private) -> index = NULL;
+
+    for (i = 0; i < index -> size; i++)
+      {
+        entry = index -> bucket[i];
+        while (entry)
+          {
+            next = entry -> next;
+            memFreeString(__FILE__, __LINE__, entry -> label);
+            memFree(__FILE__, __LINE__, entry, sizeof(NODEINDEXENTRY));
+            entry = next;
+          }
+      }
+
+    if (index -> names)
+      {
+        memFree(__FILE__, __LINE__, index -> names,
+            index -> namesize * sizeof(char*));
+      }
+    memFree(__FILE__, __LINE__, index -> bucket,
+        index -> size * sizeof(NODEINDEXENTRY*));
+    memFree(__FILE__, __LINE__, index, sizeof(NODEINDEX));
+  }
+
+
+/* #############################################################################
+ *
+ * Description    get the label index of the current node and build it if
+ *                it doesn't exist yet; the index stays with the node when
+ *                the node is left, so it's only built once per node and
+ *                kept up to date by the functions which change the children
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         NODEINDEX* index of the current node
+ */
+NODEINDEX* nodeIndexGet(void)
+  {
+    NODEINDEX*          index;
+    NODEINFO*           info;
+    xmlNode*            curnode;
+
+    TRACE(99, "nodeIndexGet()", NULL);
+
+    info = nodeInfoAttach(xmlwalklist[level - 1]);
+    if (info -> index)
+      { return info -> index; }
+
+    index = memAlloc(__FILE__, __LINE__, sizeof(NODEINDEX));
+    index -> prev = NULL;
+    index -> next = xmlindexlist;
+    index -> parent = xmlwalklist[level - 1];
+    index -> bucket = NULL;
+    index -> names = NULL;
+    index -> count = 0;
+    index -> generation = 0;
+    index -> namegeneration = -1;
+    index -> namesize = 0;
+    index -> size = 0;
+    nodeIndexResize(index, NODEINDEX_MINSIZE);
+
+    curnode = xmlwalklist[level - 1] -> children;
+    while (curnode)
+      {
+        if (curnode -> type == XML_ELEMENT_NODE &&
+            !strcmp((char*)curnode -> name, "node"))
+          { nodeIndexAdd(index, curnode, 0); }
+
+        curnode = curnode -> next;
+      }
+
+    if (xmlindexlist)
+      { xmlindexlist -> prev = index; }
+    xmlindexlist = index;
+    info -> index = index;
+
+    return index;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    get the sorted list of all labels of an index; the list is
+ *                cached and only sorted again if the children of the level
+ *                changed since the last call
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      NODEINDEX* index  - index to get the labels of
+ * Return         char** sorted list of labels, owned by the index
+ */
+char** nodeIndexNames(NODEINDEX* index)
+  {
+    NODEINDEXENTRY*     entry;
+    int                 i,
+                        id = 0;
+
+    TRACE(99, "nodeIndexNames()", NULL);
+
+    if (index -> names &&
+        index -> namegeneration == index -> generation)
+      { return index -> names; }
+
+    if (index -> namesize < index -> count + 1)
+      {
+        index -> names = memRealloc(__FILE__, __LINE__, index -> names,
+            index -> namesize * sizeof(char*),
+            (index -> count + 1) * sizeof(char*));
+        index -> namesize = index -> count + 1;
+      }
+
+    for (i = 0; i < index -> size; i++)
+      {
+        entry = index -> bucket[i];
+        while (entry)
+          {
+            index -> names[id++] = entry -> label;
+            entry = entry -> next;
+          }
+      }
+    index -> names[id] = NULL;
+
+    qsort(index -> names, id, sizeof(char*), nodeSort);
+
+    index -> namegeneration = index -> generation;
+
+    return index -> names;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    remove a node from a label index; the node is found in the
+ *                bucket of its label, so the label must not have changed
+ *                since the node was added
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      NODEINDEX* index  - index to remove the node from
+ *                xmlNode* node     - the node to remove
+ * Return         void
+ */
+void nodeIndexRemove(NODEINDEX* index, xmlNode* node)
+  {
+    NODEINDEXENTRY*     entry;
+    NODEINDEXENTRY**    link;
+    char*               label;
+
+    TRACE(99, "nodeIndexRemove()", NULL);
+
+    if (!index)
+      { return; }
+
+    label = nodeInfoShadow(node) -> terminal;
+    if (!label)
+      {   /* nodes without a label never are in the index */
+        return;
+      }
+
+    link = &index -> bucket[strHash(label) & (index -> size - 1)];
+    while (*link)
+      {
+        entry = *link;
+        if (entry -> node == node)
+          {
+            *link = entry -> next;
+            memFreeString(__FILE__, __LINE__, entry -> label);
+            memFree(__FILE__, __LINE__, entry, sizeof(NODEINDEXENTRY));
+            index -> count--;
+            index -> generation++;
+            return;
+          }
+
+        link = &entry -> next;
+      }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    resize the bucket array of a label index and rehash all
+ *                entries
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      NODEINDEX* index  - index to resize
+ *                int size          - new number of buckets, a power of 2
+ * Return         void
+ */
+void nodeIndexResize(NODEINDEX* index, int size)
+  {
+    NODEINDEXENTRY**    bucket;
+    NODEINDEXENTRY**    tail;
+    NODEINDEXENTRY*     entry;
+    NODEINDEXENTRY*     next;
+    int                 i;
+
+    TRACE(99, "nodeIndexResize()", NULL);
+
+    bucket = memAlloc(__FILE__, __LINE__, size * sizeof(NODEINDEXENTRY*));
+    for (i = 0; i < size; i++)
+      { bucket[i] = NULL; }
+
+    for (i = 0; i < index -> size; i++)
+      {
+        entry = index -> bucket[i];
+        while (entry)
+          {
+            next = entry -> next;
+            entry -> next = NULL;
+
+            tail = &bucket[entry -> hash & (size - 1)];
+            while (*tail)
+              { tail = &(*tail) -> next; }
+            *tail = entry;
+
+            entry = next;
+          }
+      }
+
+    if (index -> bucket)
+      {
+        memFree(__FILE__, __LINE__, index -> bucket,
+            index -> size * sizeof(NODEINDEXENTRY*));
+      }
+
+    index -> bucket = bucket;
+    index -> size = size;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    get the data attached to a node; if the node has none yet,
+ *                empty data is attached
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      xmlNode* node - node to get the data of
+ * Return         NODEINFO* data of the node
+ */
+NODEINFO* nodeInfoAttach(xmlNode* node)
+  {
+    NODEINFO*           info = node -> _private;
+
+    TRACE(99, "nodeInfoAttach()", NULL);
+
+    if (!info)
+      {
+        if (!nodeinfoarena)
+          { nodeinfoarena = memArenaCreate(0); }
+
+        /* the memory of the arena is zeroed, so the data is invalid */
+        info = memArenaAlloc(nodeinfoarena, sizeof(NODEINFO));
+        node -> _private = info;
+      }
+
+    return info;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    get the decoded creation and modification data of a node;
+ *                the data is attached to the node on first access and kept
+ *                until xmlInterfaceUpdateTimestamp() changes the node
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      xmlNode* node - node to get the data of
+ * Return         NODEINFO* data of the node
+ */
+NODEINFO* nodeInfoGet(xmlNode* node)
+  {
+    NODEINFO*           info;
+
+    TRACE(99, "nodeInfoGet()", NULL);
+
+    info = nodeInfoAttach(node);
+    if (info -> valid)
+      { return info; }
+
+    info -> created_by = nodeInfoParseId(node, "created-by");
+    info -> modified_by = nodeInfoParseId(node, "modified-by");
+    nodeInfoParseTime(node, "created-on", &info -> created_on);
+    nodeInfoParseTime(node, "modified-on", &info -> modified_on);
+    info -> valid = 1;
+
+    return info;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    read an editor id attribute of a node
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      xmlNode* node     - node to read the attribute of
+ *                const char* name  - name of the attribute
+ * Return         int editor id, 0 if the attribute is missing or empty
+ */
+int nodeInfoParseId(xmlNode* node, const char* name)
+  {
+    xmlChar*            prop;
+    int                 uid = 0;
+
+    TRACE(99, "nodeInfoParseId()", NULL);
+
+    prop = xmlGetProp(node, BAD_CAST name);
+    if (prop)
+      {
+        /* Flawfinder: ignore */
+        uid = atoi((char*)prop);
+        xmlFree(prop);
+      }
+
+    return uid;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    read a timestamp attribute of a node; timestamps which are
+ *                not in the format written by xmlInterfaceUpdateTimestamp()
+ *                are marked as raw and read again when they are displayed
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      xmlNode* node     - node to read the attribute of
+ *                const char* name  - name of the attribute
+ *                NODETIME* ntime   - the parsed timestamp
+ * Return         void
+ */
+void nodeInfoParseTime(xmlNode* node, const char* name, NODETIME* ntime)
+  {
+    xmlChar*            prop;
+    int                 day,
+                        hour,
+                        minute,
+                        month,
+                        second,
+                        size = 0,
+                        year;
+
+    TRACE(99, "nodeInfoParseTime()", NULL);
+
+    prop = xmlGetProp(node, BAD_CAST name);
+    if (!prop)
+      {
+        ntime -> state = NODETIME_NONE;
+        return;
+      }
+
+    if (sscanf((char*)prop, "%4d-%2d-%2d %2d:%2d:%2d%n",
+            &year, &month, &day, &hour, &minute, &second, &size) == 6 &&
+        size == 19 &&
+        !prop[size] &&
+        month >= 1 && month <= 12 &&
+        day >= 1 && day <= 31 &&
+        hour >= 0 && hour <= 23 &&
+        minute >= 0 && minute <= 59 &&
+        second >= 0 && second <= 60)
+      {
+        ntime -> year = year;
+        ntime -> month = month;
+        ntime -> day = day;
+        ntime -> hour = hour;
+        ntime -> minute = minute;
+        ntime -> second = second;
+        ntime -> state = NODETIME_PARSED;
+      }
+    else
+      { ntime -> state = NODETIME_RAW; }
+
+    xmlFree(prop);
+  }
+
+
+/* #############################################################################
+ *
+ * Description    get the data attached to a node together with its label and
+ *                comment in the terminal encoding; they are converted on
+ *                first access and kept until the node is edited, so the
+ *                readers never have to convert them again
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      xmlNode* node - node to get the data of
+ * Return         NODEINFO* data of the node
+ */
+NODEINFO* nodeInfoShadow(xmlNode* node)
+  {
+    NODEINFO*           info;
+    xmlNode*            curnode;
+    xmlChar*            content;
+    char*               string;
+
+    TRACE(99, "nodeInfoShadow()", NULL);
+
+    info = nodeInfoAttach(node);
+    if (info -> shadowed)
+      { return info; }
+
+    /* a label which can't be converted stays NULL */
+    content = xmlGetProp(node, BAD_CAST "label");
+    string = convert2terminal(content);
+    if (string)
+      {
+        info -> terminal = nodeInfoStore(info -> terminal,
+            &info -> terminalsize, string);
+      }
+    else
+      { info -> terminal = NULL; }
+    if (content)
+      { xmlFree(content); }
+
+    info -> comment = NULL;
+    curnode = node -> children;
+    while (curnode)
+      {
+        if (curnode -> type == XML_ELEMENT_NODE &&
+            !strcmp((char*)curnode -> name, "comment"))
+          {   /* we found our comment node, there can only be one */
+            content = xmlNodeGetContent(curnode);
+            string = convert2terminal(content);
+            if (string)
+              {
+                info -> comment = nodeInfoStore(info -> comment,
+                    &info -> commentsize, string);
+              }
+            if (content)
+              { xmlFree(content); }
+            break;
+          }
+
+        curnode = curnode -> next;
+      }
+
+    info -> shadowed = 1;
+
+    return info;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    store a string in a slot of the data of a node; the memory
+ *                of the slot is reused as long as the string fits and grows
+ *                by doubling otherwise, so editing a node again and again
+ *                doesn't keep on filling the arena
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      char* slot          - memory of the slot or NULL
+ *                int* size           - size of the memory of the slot
+ *                const char* string  - string to store
+ * Return         char* the slot containing the string
+ */
+char* nodeInfoStore(char* slot, int* size, const char* string)
+  {
+    int                 length = strlen(string) + 1;
+
+    TRACE(99, "nodeInfoStore()", NULL);
+
+    if (!slot ||
+        length > *size)
+      {
+        *size = (length > *size * 2) ? length : *size * 2;
+        slot = memArenaAlloc(nodeinfoarena, *size);
+      }
+
+    /* Flawfinder: ignore */
+    strcpy(slot, string);
+
+    return slot;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    format a cached timestamp for display
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      xmlNode* node     - node the timestamp belongs to
+ *                const char* name  - name of the attribute
+ *                NODETIME* ntime   - the parsed timestamp
+ *                MEMARENA* arena   - arena for the result or NULL
+ * Return         char* the timestamp, "---" if it doesn't exist
+ */
+char* nodeInfoTimeString(xmlNode* node, const char* name, NODETIME* ntime,
+    MEMARENA* arena)
+  {
+    xmlChar*            prop;
+    char*               result;
+    /* Flawfinder: ignore */
+    char                tdisplay[21];
+
+    TRACE(99, "nodeInfoTimeString()", NULL);
+
+    switch (ntime -> state)
+      {
+        case NODETIME_PARSED:
+            snprintf(tdisplay, 21, "%04d-%02d-%02d %02d:%02d:%02d",
+                ntime -> year,
+                ntime -> month,
+                ntime -> day,
+                ntime -> hour,
+                ntime -> minute,
+                ntime -> second);
+            return stringCopy(arena, tdisplay);
+        case NODETIME_RAW:
+            prop = xmlGetProp(node, BAD_CAST name);
+            result = convert2terminal(prop);
+            result = stringCopy(arena, (result) ? result : "---");
+            if (prop)
+              { xmlFree(prop); }
+            return result;
+        default:
+            return stringCopy(arena, "---");
+      }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    get the UTF-8 label of a node without copying it; only if
+ *                the attribute is not a single text node, the value is
+ *                built in the arena of the walk path
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      xmlNode* node   - the node to get the label of
+ *                WALKPATH* path  - the path of the walk
+ * Return         char* borrowed label or NULL if the node has none
+ */
+char* nodeLabel(xmlNode* node, WALKPATH* path)
+  {
+    xmlAttr*            attr;
+    xmlChar*            prop;
+    char*               label;
+
+    TRACE(99, "nodeLabel()", NULL);
+
+    attr = xmlHasProp(node, BAD_CAST "label");
+    if (!attr)
+      { return NULL; }
+
+    if (attr -> children &&
+        attr -> children -> type == XML_TEXT_NODE &&
+        !attr -> children -> next)
+      { return (char*)attr -> children -> content; }
+
+    prop = xmlGetProp(node, BAD_CAST "label");
+    if (!prop)
+      { return NULL; }
+
+    if (!path -> arena)
+      { path -> arena = memArenaCreate(0); }
+    label = memArenaString(path -> arena, (char*)prop);
+    xmlFree(prop);
+
+    return label;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    qsort function to sort the node names
+ * Author         Harry Brueckner
+ * Date           2005-03-27
+ * Arguments      const void* node1   - label of node 1
+ *                const void* node2   - label of node 2
+ * Return         strcmp result of the names
+ */
+static int nodeSort(const void* node1, const void* node2)
+  {
+    char**              label1 = (char**)node1;
+    char**              label2 = (char**)node2;
+
+    TRACE(99, "nodeSort()", NULL);
+
+    return strcmp(label1[0], label2[0]);
+  }
+
+
+/* #############################################################################
+ *
+ * Description    callback function for xml tree walking which attaches the
+ *                label and the comment in the terminal encoding to every node
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      WALKPATH* path  - path we are currently at
+ * Return         int WALK_CONTINUE
+ */
+int shadowVisit(WALKPATH* path)
+  {
+    TRACE(99, "shadowVisit()", NULL);
+
+    nodeInfoShadow(path -> node[path -> depth - 1]);
 
-    return NULL;
+    return WALK_CONTINUE;
   }
 
 
 /* #############################################################################
  *
- * Description    find an editor by his name
- * Author         Harry Brueckner
- * Date           2005-04-06
- * Arguments      char* editor  - name of the editor
- * Return         int user id of the editor
+ * Description    copy a string either into an arena or into newly allocated
+ *                memory
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      MEMARENA* arena     - arena to use or NULL
+ *                const char* string  - string to copy
+ * Return         char* copy of the string
  */
-int editorFindByName(char* editor)
+char* stringCopy(MEMARENA* arena, const char* string)
   {
-    xmlNode*            curnode;
-    int                 uid;
-    char*               prop;
-    char*               user;
-
-    TRACE(99, "editorFindByName()", NULL);
-
-    if (!editorsnode)
-      { createEditorsNode(); }
+    char*               result;
 
-    if (!editor)
-      { return editorFindByName("unknown"); }
+    TRACE(99, "stringCopy()", NULL);
 
-    curnode = editorsnode -> children;
-    while (curnode)
-      {
-        if (curnode -> type == XML_ELEMENT_NODE &&
-            !strcmp((char*)curnode -> name, "user"))
-          {
-            user = convert2terminal(xmlNodeGetContent(curnode));
-            if (!strcmp(user, editor))
-              {   /* we found the user */
-                prop = convert2terminal(xmlGetProp(curnode, BAD_CAST "uid"));
-                if (prop)
-                  {   /* we found a user */
-                    /* Flawfinder: ignore */
-                    uid = atoi(prop);
-                    if (uid > 0)
-                      { return uid; }
-                    else
-                      { return -1; }
-                  }
-              }
-          }
+    if (arena)
+      { return memArenaString(arena, string); }
 
-        curnode = curnode -> next;
-      }
+    result = memAlloc(__FILE__, __LINE__, strlen(string) + 1);
+    strStrncpy(result, string, strlen(string) + 1);
 
-    return -1;
+    return result;
   }
 
 
+#ifdef TEST_OPTION
 /* #############################################################################
  *
- * Description    free the XML parser stuff
- * Author         Harry Brueckner
- * Date           2005-03-18
+ * Description    test the tree walk on a very deep tree; a chain of
+ *                TREEWALK_DEPTH nodes is added below the root, walked in
+ *                full, with its subtree skipped and stopped at its end and
+ *                removed again
+ * Author         agent
+ * Date           2026-10-17
  * Arguments      void
  * Return         void
  */
-void freeXMLInterface(void)
+void testTreeWalk(void)
   {
-    TRACE(99, "freeXMLInterface()", NULL);
+    xmlNode*            chain = NULL;
+    xmlNode*            curnode;
+    /* Flawfinder: ignore */
+    char                label[32];
+    int                 i,
+                        nodes,
+                        ok = 1;
 
-    if (xmlwalklist)
+    TRACE(99, "testTreeWalk()", NULL);
+
+    curnode = xmlGetDocumentRoot();
+    for (i = 1; i <= TREEWALK_DEPTH; i++)
       {
-        memFree(__FILE__, __LINE__, xmlwalklist, maxlevel * sizeof(xmlNode*));
-        xmlwalklist = NULL;
+        curnode = xmlNewChild(curnode, NULL, BAD_CAST "node", NULL);
+        snprintf(label, 32, "deep%d", i);
+        xmlNewProp(curnode, BAD_CAST "label", BAD_CAST label);
+        if (!chain)
+          { chain = curnode; }
       }
+    labelsshadowed = 0;
+
+    /* the full walk must reach the end of the chain */
+    testwalkdepth = testwalknodes = 0;
+    testwalklabel = NULL;
+    if (xmlInterfaceTreeWalk(NULL, testTreeWalkVisit) != WALK_CONTINUE)
+      { ok = 0; }
+    snprintf(label, 32, "deep%d", TREEWALK_DEPTH);
+    if (testwalkdepth < TREEWALK_DEPTH ||
+        !testwalklabel ||
+        strcmp(testwalklabel, label))
+      { ok = 0; }
+    nodes = testwalknodes;
+
+    /* skipping the chain must leave out everything below its start */
+    testwalknodes = 0;
+    if (xmlInterfaceTreeWalk(NULL, testTreeWalkSkip) != WALK_CONTINUE ||
+        testwalknodes != nodes - TREEWALK_DEPTH + 1)
+      { ok = 0; }
+
+    /* and the walk must end as soon as the visitor stops it */
+    testwalknodes = 0;
+    if (xmlInterfaceTreeWalk(chain, testTreeWalkSkip) != WALK_STOP ||
+        testwalknodes != 1)
+      { ok = 0; }
+
+    xmlUnlinkNode(chain);
+    xmlFreeNode(chain);
+
+    printf("tree walk %s\n", (ok) ? "ok" : "failed");
   }
 
 
 /* #############################################################################
  *
- * Description    initialize the XML parser
- * Author         Harry Brueckner
- * Date           2005-03-18
- * Arguments      void
- * Return         void
+ * Description    visitor for the skip test of testTreeWalk(); the subtree
+ *                of the chain is skipped and the walk is stopped at its
+ *                second node
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      WALKPATH* path  - path we are currently at
+ * Return         int WALK_SKIP for the start of the chain, WALK_STOP for its
+ *                second node, otherwise WALK_CONTINUE
  */
-void initXMLInterface(void)
+int testTreeWalkSkip(WALKPATH* path)
   {
-    TRACE(99, "initXMLInterface()", NULL);
+    char*               label = path -> label[path -> depth - 1];
 
-    level = 0;
-    maxlevel = 0;
+    TRACE(99, "testTreeWalkSkip()", NULL);
 
-    editorsnode = NULL;
-    templatenode = NULL;
-    xmlwalklist = NULL;
+    testwalknodes++;
+
+    if (!strcmp(label, "deep1"))
+      { return WALK_SKIP; }
+    if (!strcmp(label, "deep2"))
+      { return WALK_STOP; }
+
+    return WALK_CONTINUE;
   }
 
 
 /* #############################################################################
  *
- * Description    see if a node witht the passed label exists in the current
- *                node
- * Author         Harry Brueckner
- * Date           2005-03-29
- * Arguments      char* label - label of the node to find
- * Return         xmlNode* pointing to the found node
+ * Description    visitor for the full walk of testTreeWalk(); it counts the
+ *                nodes and remembers the label of the deepest one
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      WALKPATH* path  - path we are currently at
+ * Return         int WALK_CONTINUE
  */
-xmlNode* nodeFind(char* label)
+int testTreeWalkVisit(WALKPATH* path)
   {
-    xmlNode*            curnode;
-    char*               prop;
-
-    TRACE(99, "nodeFind()", NULL);
-
-    if (!level || !label)
-      { return 0; }
+    TRACE(99, "testTreeWalkVisit()", NULL);
 
-    curnode = xmlwalklist[level - 1] -> children;
-    while (curnode)
+    testwalknodes++;
+    if (path -> depth > testwalkdepth)
       {
-        if (curnode -> type == XML_ELEMENT_NODE &&
-            !strcmp((char*)curnode -> name, "node"))
-          {
-            prop = convert2terminal(xmlGetProp(curnode, BAD_CAST "label"));
-            if (prop &&
-                !strcmp(label, prop))
-              {   /* we found the label */
-                return curnode;
-              }
-          }
-
-        curnode = curnode -> next;
+        testwalkdepth = path -> depth;
+        testwalklabel = path -> label[path -> depth - 1];
       }
 
-    return NULL;
+    return WALK_CONTINUE;
   }
+#endif
 
 
 /* #############################################################################
  *
- * Description    qsort function to sort the node names
- * Author         Harry Brueckner
- * Date           2005-03-27
- * Arguments      const void* node1   - label of node 1
- *                const void* node2   - label of node 2
- * Return         strcmp result of the names
+ * Description    walk from the given node through its siblings and all nodes
+ *                below them; the walk is iterative and uses the nodes of the
+ *                path as its stack, so even very deep trees can be walked;
+ *                walks of a single node may run in several threads, so they
+ *                neither attach data to the nodes nor convert labels and
+ *                need the labels to be shadowed before
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      xmlNode* node     - the first node to walk through
+ *                int single        - 1 if the siblings of the node must not
+ *                                    be walked
+ *                WALKFN visitor    - callback function for each node
+ *                WALKPATH* path    - the path to use for the walk
+ * Return         int WALK_STOP if the visitor stopped the walk, otherwise
+ *                WALK_CONTINUE
  */
-static int nodeSort(const void* node1, const void* node2)
+int treeWalk(xmlNode* node, int single, WALKFN visitor, WALKPATH* path)
   {
-    char**              label1 = (char**)node1;
-    char**              label2 = (char**)node2;
+    NODEINFO*           info;
+    xmlNode*            curnode = node;
+    char*               label;
+    int                 action = WALK_CONTINUE,
+                        depth = 0,
+                        size;
 
-    TRACE(99, "nodeSort()", NULL);
+    TRACE(99, "treeWalk()", NULL);
 
-    return strcmp(label1[0], label2[0]);
+    while (curnode || depth)
+      {
+        if (!curnode)
+          {   /* this level is done, we continue with the parent's sibling */
+            depth--;
+            curnode = path -> node[depth];
+            path -> label[depth] = NULL;
+            path -> folded[depth] = NULL;
+            path -> terminal[depth] = NULL;
+            path -> depth = depth;
+            if (single && !depth)
+              { break; }
+
+            curnode = curnode -> next;
+            continue;
+          }
+
+        if (curnode -> type == XML_ELEMENT_NODE &&
+            !strcmp((char*)curnode -> name, "node") &&
+            (label = nodeLabel(curnode, path)))
+          {
+            if (depth >= path -> size)
+              {   /* the stack only grows when we get deeper than ever */
+                size = (path -> size) ? path -> size * 2 : WALKPATH_MINSIZE;
+                path -> label = memRealloc(__FILE__, __LINE__,
+                    path -> label,
+                    (path -> size) ? (path -> size + 1) * sizeof(char*) : 0,
+                    (size + 1) * sizeof(char*));
+                path -> folded = memRealloc(__FILE__, __LINE__,
+                    path -> folded,
+                    (path -> size) ? (path -> size + 1) * sizeof(char*) : 0,
+                    (size + 1) * sizeof(char*));
+                path -> terminal = memRealloc(__FILE__, __LINE__,
+                    path -> terminal,
+                    (path -> size) ? (path -> size + 1) * sizeof(char*) : 0,
+                    (size + 1) * sizeof(char*));
+                path -> node = memRealloc(__FILE__, __LINE__,
+                    path -> node,
+                    path -> size * sizeof(xmlNode*),
+                    size * sizeof(xmlNode*));
+                path -> size = size;
+              }
+
+            info = curnode -> _private;
+            path -> label[depth] = label;
+            path -> label[depth + 1] = NULL;
+            path -> folded[depth] = (info && info -> folded) ?
+                info -> folded : label;
+            path -> folded[depth + 1] = NULL;
+            if (info && info -> shadowed)
+              { path -> terminal[depth] = info -> terminal; }
+            else
+              {   /* the node was never shadowed, we convert it ourself */
+                assert(!single);
+                if (!path -> arena)
+                  { path -> arena = memArenaCreate(0); }
+                path -> terminal[depth] = convertArena(1, label, path -> arena);
+              }
+            path -> terminal[depth + 1] = NULL;
+            path -> node[depth] = curnode;
+            path -> depth = ++depth;
+
+            action = (visitor)(path);
+            if (action == WALK_STOP)
+              { break; }
+            if (action == WALK_CONTINUE &&
+                curnode -> children)
+              {   /* the node stays on the path while we walk its children */
+                curnode = curnode -> children;
+                continue;
+              }
+
+            path -> label[--depth] = NULL;
+            path -> folded[depth] = NULL;
+            path -> terminal[depth] = NULL;
+            path -> depth = depth;
+          }
+
+        if (single && !depth)
+          { break; }
+        curnode = curnode -> next;
+      }
+
+    path -> depth = 0;
+    if (path -> label)
+      {
+        path -> label[0] = NULL;
+        path -> folded[0] = NULL;
+        path -> terminal[0] = NULL;
+      }
+    if (path -> arena)
+      { memArenaReset(path -> arena); }
+
+    return (action == WALK_STOP) ? WALK_STOP : WALK_CONTINUE;
   }
 
 
@@ -441,6 +1756,7 @@ static int nodeSort(const void* node1, const void* node2)
  */
 void xmlInterfaceAddNode(char* label)
   {
+    NODEINDEX*          index;
     xmlNode*            node;
 
     TRACE(99, "xmlInterfaceAddNode()", NULL);
@@ -458,6 +1774,11 @@ void xmlInterfaceAddNode(char* label)
 
     xmlNewProp(node, BAD_CAST "label", convert2xml(label));
     xmlSetCreation(node);
+    nodeInfoShadow(node);
+
+    index = nodeInfoAttach(xmlwalklist[level - 1]) -> index;
+    if (index)
+      { nodeIndexAdd(index, node, 0); }
   }
 
 
@@ -479,6 +1800,8 @@ void xmlInterfaceDeleteNode(char* label)
     if (!node)
       { return; }
 
+    nodeIndexRemove(nodeIndexGet(), node);
+    nodeIndexDrop(node);
     xmlUnlinkNode(node);
   }
 
@@ -494,6 +1817,7 @@ void xmlInterfaceDeleteNode(char* label)
  */
 void xmlInterfaceEditNode(char* label_old, char* label_new)
   {
+    NODEINFO*           info;
     xmlNode*            node;
 
     TRACE(99, "xmlInterfaceEditNode()", NULL);
@@ -502,8 +1826,40 @@ void xmlInterfaceEditNode(char* label_old, char* label_new)
     if (!node)
       { return; }
 
+    nodeIndexRemove(nodeIndexGet(), node);
     xmlSetProp(node, BAD_CAST "label", convert2xml(label_new));
     xmlSetModification(node);
+    info = nodeInfoShadow(node);
+    info -> terminal = nodeInfoStore(info -> terminal, &info -> terminalsize,
+        label_new);
+    nodeIndexAdd(nodeIndexGet(), node, 1);
+  }
+
+
+/* #############################################################################
+ *
+ * Description    fold the case of all labels once, so a case insensitive
+ *                search can compare the labels like a case sensitive one;
+ *                the folded labels are valid until the nodes change
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         void
+ */
+void xmlInterfaceFoldLabels(void)
+  {
+    WALKPATH            path;
+
+    TRACE(99, "xmlInterfaceFoldLabels()", NULL);
+
+    if (labelsfolded)
+      { return; }
+
+    xmlInterfaceWalkPathInit(&path);
+    treeWalk(xmlGetDocumentRoot() -> children, 0, foldVisit, &path);
+    xmlInterfaceWalkPathFree(&path);
+
+    labelsfolded = 1;
   }
 
 
@@ -528,16 +1884,14 @@ void xmlInterfaceFreeNames(char** list)
  * Description    get the comment of a node
  * Author         Harry Brueckner
  * Date           2005-04-05
- * Arguments      char* label   - label of the node
+ * Arguments      char* label       - label of the node
+ *                MEMARENA* arena   - arena for the result or NULL
  * Return         char* containing the data
  */
-char* xmlInterfaceGetComment(char* label)
+char* xmlInterfaceGetComment(char* label, MEMARENA* arena)
   {
-    xmlNode*            commentnode = NULL;
-    xmlNode*            curnode;
     xmlNode*            node;
     char*               comment;
-    char*               result;
 
     TRACE(99, "xmlInterfaceGetComment()", NULL);
 
@@ -545,27 +1899,12 @@ char* xmlInterfaceGetComment(char* label)
     if (!node)
       { return NULL; }
 
-    curnode = node -> children;
-    while (curnode)
-      {
-        if (curnode -> type == XML_ELEMENT_NODE &&
-            !strcmp((char*)curnode -> name, "comment"))
-          {   /* we found our comment node, there can only be one */
-            commentnode = curnode;
-            break;
-          }
-
-        curnode = curnode -> next;
-      }
-
-    if (!commentnode)
+    comment = nodeInfoShadow(node) -> comment;
+    if (!comment ||
+        !*comment)
       { return NULL; }
 
-    comment = convert2terminal(xmlNodeGetContent(commentnode));
-    result = memAlloc(__FILE__, __LINE__, strlen(comment) + 1);
-    strStrncpy(result, comment, strlen(comment) + 1);
-
-    return result;
+    return stringCopy(arena, comment);
   }
 
 
@@ -574,16 +1913,17 @@ char* xmlInterfaceGetComment(char* label)
  * Description    get the creation label of a node
  * Author         Harry Brueckner
  * Date           2005-04-05
- * Arguments      char* label   - label of the node
- *                char** by     - the 'by' part of the label
- *                char** on     - the 'on' part of the label
+ * Arguments      char* label       - label of the node
+ *                char** by         - the 'by' part of the label
+ *                char** on         - the 'on' part of the label
+ *                MEMARENA* arena   - arena for the results or NULL
  * Return         char* containing the data
  */
-void xmlInterfaceGetCreationLabel(char* label, char** by, char**on)
+void xmlInterfaceGetCreationLabel(char* label, char** by, char**on,
+    MEMARENA* arena)
   {
+    NODEINFO*           info;
     xmlNode*            node;
-    char*               propby;
-    char*               propon;
 
     TRACE(99, "xmlInterfaceGetCreationLabel()", NULL);
 
@@ -594,17 +1934,9 @@ void xmlInterfaceGetCreationLabel(char* label, char** by, char**on)
     if (!node)
       { return; }
 
-    propby = convert2terminal(xmlGetProp(node, BAD_CAST "created-by"));
-    if (!propby || !strlen(propby))
-      { propby = "0"; }
-    /* Flawfinder: ignore */
-    *by = editorFindById(atoi(propby));
-
-    propon = convert2terminal(xmlGetProp(node, BAD_CAST "created-on"));
-    if (!propon)
-      { propon = "---"; }
-    *on = memAlloc(__FILE__, __LINE__, strlen(propon) + 1);
-    strStrncpy(*on, propon, strlen(propon) + 1);
+    info = nodeInfoGet(node);
+    *by = editorFindById(info -> created_by, arena);
+    *on = nodeInfoTimeString(node, "created-on", &info -> created_on, arena);
   }
 
 
@@ -613,16 +1945,17 @@ void xmlInterfaceGetCreationLabel(char* label, char** by, char**on)
  * Description    get the modification label of a node
  * Author         Harry Brueckner
  * Date           2005-04-05
- * Arguments      char* label   - label of the node
- *                char** by     - the 'by' part of the label
- *                char** on     - the 'on' part of the label
+ * Arguments      char* label       - label of the node
+ *                char** by         - the 'by' part of the label
+ *                char** on         - the 'on' part of the label
+ *                MEMARENA* arena   - arena for the results or NULL
  * Return         char* containing the data
  */
-void xmlInterfaceGetModificationLabel(char* label, char** by, char**on)
+void xmlInterfaceGetModificationLabel(char* label, char** by, char**on,
+    MEMARENA* arena)
   {
+    NODEINFO*           info;
     xmlNode*            node;
-    char*               propby;
-    char*               propon;
 
     TRACE(99, "xmlInterfaceGetModificationLabel()", NULL);
 
@@ -633,85 +1966,93 @@ void xmlInterfaceGetModificationLabel(char* label, char** by, char**on)
     if (!node)
       { return; }
 
-    propby = convert2terminal(xmlGetProp(node, BAD_CAST "modified-by"));
-    if (!propby || !strlen(propby))
-      { propby = "0"; }
-    /* Flawfinder: ignore */
-    *by = editorFindById(atoi(propby));
+    info = nodeInfoGet(node);
+    *by = editorFindById(info -> modified_by, arena);
+    *on = nodeInfoTimeString(node, "modified-on", &info -> modified_on, arena);
+  }
+
 
-    propon = convert2terminal(xmlGetProp(node, BAD_CAST "modified-on"));
-    if (!propon)
-      { propon = "---"; }
-    *on = memAlloc(__FILE__, __LINE__, strlen(propon) + 1);
-    strStrncpy(*on, propon, strlen(propon) + 1);
+/* #############################################################################
+ *
+ * Description    get the number of nodes in the current node
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         int number of nodes
+ */
+int xmlInterfaceCountNames(void)
+  {
+    TRACE(99, "xmlInterfaceCountNames()", NULL);
+
+    return nodeIndexGet() -> count;
   }
 
 
 /* #############################################################################
  *
- * Description    get all node names of the current node
+ * Description    get a copy of all node names of the current node, sorted
  * Author         Harry Brueckner
  * Date           2005-03-24
- * Arguments      void
+ * Arguments      MEMARENA* arena - arena for the list or NULL; a list from
+ *                                  an arena must not be freed with
+ *                                  xmlInterfaceFreeNames()
  * Return         char** array of all nodes
  */
-char** xmlInterfaceGetNames(void)
+char** xmlInterfaceGetNames(MEMARENA* arena)
   {
-    xmlNode*            curnode;
-    xmlChar*            prop;
+    NODEINDEX*          index;
     char**              list;
-    char*               pconv;
-    int                 counter = 0,
-                        i = 0;
+    char**              names;
+    int                 i;
 
     TRACE(99, "xmlInterfaceGetNames()", NULL);
 
-    /* first we count how many children there are */
-    curnode = xmlwalklist[level - 1] -> children;
-    while (curnode)
-      {
-        if (curnode -> type == XML_ELEMENT_NODE &&
-            !strcmp((char*)curnode -> name, "node"))
-          { counter++; }
-
-        curnode = curnode -> next;
-      }
-
-    if (!counter)
+    index = nodeIndexGet();
+    if (!index -> count)
       { return NULL; }
 
-    /* then we allocate the memory */
-    list = memAlloc(__FILE__, __LINE__, (counter + 1) * sizeof(char*));
+    names = nodeIndexNames(index);
 
-    /* and finally we fill the array */
-    curnode = xmlwalklist[level - 1] -> children;
-    while (curnode)
+    if (arena)
+      { list = memArenaAlloc(arena, (index -> count + 1) * sizeof(char*)); }
+    else
       {
-        if (curnode -> type == XML_ELEMENT_NODE &&
-            !strcmp((char*)curnode -> name, "node"))
-          {
-            prop = xmlGetProp(curnode, BAD_CAST "label");
-            if (prop)
-              {
-                pconv = convert2terminal(prop);
-                list[i] = memAlloc(__FILE__, __LINE__, strlen(pconv) + 1);
-                strStrncpy(list[i], pconv, strlen(pconv) + 1);
-
-                i++;
-              }
-          }
-
-        curnode = curnode -> next;
+        list = memAlloc(__FILE__, __LINE__,
+            (index -> count + 1) * sizeof(char*));
       }
 
+    for (i = 0; names[i]; i++)
+      { list[i] = stringCopy(arena, names[i]); }
     list[i] = NULL;
 
-    qsort(list, i, sizeof(char*), nodeSort);
-
     return list;
   }
 
 
+/* #############################################################################
+ *
+ * Description    borrow the sorted node names of the current node; the list
+ *                is read-only and only valid until the children of the
+ *                current node change or the node is left
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         char** array of all nodes or NULL if there are none
+ */
+char** xmlInterfaceViewNames(void)
+  {
+    NODEINDEX*          index;
+
+    TRACE(99, "xmlInterfaceViewNames()", NULL);
+
+    index = nodeIndexGet();
+    if (!index -> count)
+      { return NULL; }
+
+    return nodeIndexNames(index);
+  }
+
+
 /* #############################################################################
  *
  * Description    add another node to the walk list
@@ -743,7 +2084,6 @@ int xmlInterfaceNodeDown(char* label)
         xmlwalklist = memRealloc(__FILE__, __LINE__, xmlwalklist,
             maxlevel * sizeof(xmlNode*),
             level * sizeof(xmlNode*));
-
         maxlevel = level;
       }
 
@@ -789,7 +2129,7 @@ char* xmlInterfaceNodeGet(int id)
         id >= level)
       { return NULL; }
 
-    return convert2terminal(xmlGetProp(xmlwalklist[id], BAD_CAST "label"));
+    return nodeInfoShadow(xmlwalklist[id]) -> terminal;
   }
 
 
@@ -825,6 +2165,7 @@ void xmlInterfaceNodeUp(void)
  */
 void xmlInterfaceSetComment(char* label, char* comment)
   {
+    NODEINFO*           info;
     xmlNode*            commentnode = NULL;
     xmlNode*            curnode;
     xmlNode*            node;
@@ -852,6 +2193,11 @@ void xmlInterfaceSetComment(char* label, char* comment)
         if (strlen(comment) == 0)
           {   /* if the comment is empty, we remove the node and are done */
             xmlUnlinkNode(commentnode);
+            info = nodeInfoShadow(node);
+            if (info -> comment)
+              {   /* the slot is kept for the next comment */
+                info -> comment[0] = 0;
+              }
             return;
           }
 
@@ -882,6 +2228,37 @@ void xmlInterfaceSetComment(char* label, char* comment)
         xmlEncodeCommentEntities(convert2xml(comment)));
     /* and its parent modification */
     xmlSetModification(node);
+    info = nodeInfoShadow(node);
+    info -> comment = nodeInfoStore(info -> comment, &info -> commentsize,
+        comment);
+  }
+
+
+/* #############################################################################
+ *
+ * Description    convert the labels and comments of all nodes into the
+ *                terminal encoding once after the document was read, so the
+ *                readers don't need to convert them again and again; nodes
+ *                added later are shadowed when they are created
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         void
+ */
+void xmlInterfaceShadowLabels(void)
+  {
+    WALKPATH            path;
+
+    TRACE(99, "xmlInterfaceShadowLabels()", NULL);
+
+    if (labelsshadowed)
+      { return; }
+
+    xmlInterfaceWalkPathInit(&path);
+    treeWalk(xmlGetDocumentRoot() -> children, 0, shadowVisit, &path);
+    xmlInterfaceWalkPathFree(&path);
+
+    labelsshadowed = 1;
   }
 
 
@@ -1053,24 +2430,21 @@ void xmlInterfaceTemplateSet(char* title)
 
 /* #############################################################################
  *
- * Description    walk through the whole tree and hand all label combinations to
- *                the CLI callback function
+ * Description    walk through the whole tree and hand the path of every node
+ *                to the visitor; the path only borrows the labels from the
+ *                document, so no memory is allocated per node. The visitor
+ *                returns WALK_CONTINUE to walk the children of the node,
+ *                WALK_SKIP to skip them or WALK_STOP to end the walk.
  * Author         Harry Brueckner
  * Date           2005-04-06
- * Arguments      xmlNode* node   - the node to walk through; if NULL is passed
- *                                  the document root is used
- *                char*** path    - path we are currently recursing through
- *                WALKFN walker   - callback function where the matching can be
- *                                  processed
- * Return         int number of found patterns
+ * Arguments      xmlNode* node     - the node to walk through; if NULL is
+ *                                    passed the document root is used
+ *                WALKFN visitor    - callback function for each node
+ * Return         int WALK_STOP if the visitor stopped the walk, otherwise
+ *                WALK_CONTINUE
  */
-int xmlInterfaceTreeWalk(xmlNode* node, char*** path, WALKFN walker)
+int xmlInterfaceTreeWalk(xmlNode* node, WALKFN visitor)
   {
-    xmlNode*            curnode;
-    char*               label;
-    int                 found = 0,
-                        level = listCount(*path);
-
     TRACE(99, "xmlInterfaceTreeWalk()", NULL);
 
     if (!node)
@@ -1078,31 +2452,28 @@ int xmlInterfaceTreeWalk(xmlNode* node, char*** path, WALKFN walker)
         node = xmlGetDocumentRoot();
       }
 
-    curnode = node -> children;
-    while (curnode)
-      {
-        if (curnode -> type == XML_ELEMENT_NODE &&
-            !strcmp((char*)curnode -> name, "node"))
-          {
-            label = convert2terminal(xmlGetProp(curnode, BAD_CAST "label"));
-            if (label)
-              {   /* we found a node we have to use in the search */
-                *path = listAdd(*path, label);
-
-                /* we call the walker function for further processing */
-                found += (walker)(*path);
-
-                /* and we recurse further down */
-                found += xmlInterfaceTreeWalk(curnode, path, walker);
+    return treeWalk(node -> children, 0, visitor, &walkpath);
+  }
 
-                *path = listDelete(*path, level);
-              }
-          }
 
-        curnode = curnode -> next;
-      }
+/* #############################################################################
+ *
+ * Description    walk through a single node and all nodes below it; the
+ *                caller owns the path, so several walks of the same document
+ *                can run at the same time as long as nobody modifies it
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      xmlNode* node     - the node to walk through
+ *                WALKFN visitor    - callback function for each node
+ *                WALKPATH* path    - the path to use for the walk
+ * Return         int WALK_STOP if the visitor stopped the walk, otherwise
+ *                WALK_CONTINUE
+ */
+int xmlInterfaceTreeWalkNode(xmlNode* node, WALKFN visitor, WALKPATH* path)
+  {
+    TRACE(99, "xmlInterfaceTreeWalkNode()", NULL);
 
-    return found;
+    return treeWalk(node, 1, visitor, path);
   }
 
 
@@ -1132,6 +2503,14 @@ void xmlInterfaceUpdateTimestamp(xmlChar* uidlabel, xmlChar* timelabel,
     if (!curnode)
       { return; }
 
+    /* the cached data of the node is outdated now */
+    if (curnode -> _private)
+      {
+        ((NODEINFO*)curnode -> _private) -> valid = 0;
+        ((NODEINFO*)curnode -> _private) -> folded = NULL;
+        labelsfolded = 0;
+      }
+
     /* these names can not have a creator */
     if (!strcmp("editor", (char*)curnode -> name) ||
         !strcmp("template", (char*)curnode -> name) ||
@@ -1174,6 +2553,59 @@ void xmlInterfaceUpdateTimestamp(xmlChar* uidlabel, xmlChar* timelabel,
   }
 
 
+
+/* #############################################################################
+ *
+ * Description    free the memory of a walk path
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      WALKPATH* path  - the path to free
+ * Return         void
+ */
+void xmlInterfaceWalkPathFree(WALKPATH* path)
+  {
+    TRACE(99, "xmlInterfaceWalkPathFree()", NULL);
+
+    if (path -> arena)
+      { memArenaFree(path -> arena); }
+
+    if (path -> size)
+      {
+        memFree(__FILE__, __LINE__, path -> label,
+            (path -> size + 1) * sizeof(char*));
+        memFree(__FILE__, __LINE__, path -> folded,
+            (path -> size + 1) * sizeof(char*));
+        memFree(__FILE__, __LINE__, path -> terminal,
+            (path -> size + 1) * sizeof(char*));
+        memFree(__FILE__, __LINE__, path -> node,
+            path -> size * sizeof(xmlNode*));
+      }
+
+    xmlInterfaceWalkPathInit(path);
+  }
+
+
+/* #############################################################################
+ *
+ * Description    initialize an empty walk path
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      WALKPATH* path  - the path to initialize
+ * Return         void
+ */
+void xmlInterfaceWalkPathInit(WALKPATH* path)
+  {
+    TRACE(99, "xmlInterfaceWalkPathInit()", NULL);
+
+    path -> label = NULL;
+    path -> folded = NULL;
+    path -> terminal = NULL;
+    path -> node = NULL;
+    path -> arena = NULL;
+    path -> data = NULL;
+    path -> depth = path -> size = 0;
+  }
+
 /* #############################################################################
  */
 
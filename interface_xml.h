@@ -34,12 +34,30 @@
   #include <libxml/tree.h>
   #include <libxml/xpath.h>
 #endif
+#include "memory.h"
 
 
 /* #############################################################################
  * global variables
  */
-typedef int (*WALKFN) (char** path);
+#define WALK_CONTINUE   0
+#define WALK_SKIP       1
+#define WALK_STOP       2
+
+typedef struct sWalkPath WALKPATH;
+struct sWalkPath
+  {
+    char**              label;    /* borrowed UTF-8 labels, NULL terminated */
+    char**              folded;   /* the labels with their case folded */
+    char**              terminal; /* the labels in the terminal encoding */
+    xmlNode**           node;
+    MEMARENA*           arena;    /* labels which can't be borrowed */
+    void*               data;     /* data of the visitor */
+    int                 depth,
+                        size;
+  };
+
+typedef int (*WALKFN) (WALKPATH* path);
 
 
 /* #############################################################################
@@ -50,25 +68,37 @@ void createTemplateNode(void);
 void freeXMLInterface(void);
 int initXMLEncoding(char* encoding);
 void initXMLInterface(void);
+#ifdef TEST_OPTION
+  void testTreeWalk(void);
+#endif
 void xmlInterfaceAddNode(char* label);
+int xmlInterfaceCountNames(void);
 void xmlInterfaceDeleteNode(char* label);
 void xmlInterfaceEditNode(char* label_old, char* label_new);
+void xmlInterfaceFoldLabels(void);
 void xmlInterfaceFreeNames(char** list);
-char* xmlInterfaceGetComment(char* label);
-void xmlInterfaceGetCreationLabel(char* label, char** by, char**on);
-void xmlInterfaceGetModificationLabel(char* label, char** by, char**on);
-char** xmlInterfaceGetNames(void);
+char* xmlInterfaceGetComment(char* label, MEMARENA* arena);
+void xmlInterfaceGetCreationLabel(char* label, char** by, char**on,
+    MEMARENA* arena);
+void xmlInterfaceGetModificationLabel(char* label, char** by, char**on,
+    MEMARENA* arena);
+char** xmlInterfaceGetNames(MEMARENA* arena);
 int xmlInterfaceNodeDown(char* label);
 int xmlInterfaceNodeExists(char* label);
 char* xmlInterfaceNodeGet(int id);
 void xmlInterfaceNodeUp(void);
 void xmlInterfaceSetComment(char* label, char* comment);
+void xmlInterfaceShadowLabels(void);
 char* xmlInterfaceTemplateGet(int id, int* is_static);
 int xmlInterfaceTemplateGetId(char* title);
 void xmlInterfaceTemplateSet(char* title);
-int xmlInterfaceTreeWalk(xmlNode* node, char*** path, WALKFN walker);
+int xmlInterfaceTreeWalk(xmlNode* node, WALKFN visitor);
+int xmlInterfaceTreeWalkNode(xmlNode* node, WALKFN visitor, WALKPATH* path);
 void xmlInterfaceUpdateTimestamp(xmlChar* uidlabel, xmlChar* timelabel,
     xmlNode* curnode);
+char** xmlInterfaceViewNames(void);
+void xmlInterfaceWalkPathFree(WALKPATH* path);
+void xmlInterfaceWalkPathInit(WALKPATH* path);
 
 
 #define xmlSetModification(node)  xmlInterfaceUpdateTimestamp( \
@@ -37,6 +37,12 @@
 static int listSortKey(const void* element1, const void* element2);
 
 
+/* #############################################################################
+ * global variables
+ */
+#define LIST_MINSIZE  8
+
+
 /* #############################################################################
  *
  * Description    add the given element to the list
@@ -70,6 +76,37 @@ char** listAdd(char** list, char*  element)
   }
 
 
+/* #############################################################################
+ *
+ * Description    append a copy of the given element to the list; the list grows
+ *                geometrically, so appending is amortized O(1)
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      LIST* list    - list to modify
+ *                char* element - new element to add
+ * Return         void
+ */
+void listAppend(LIST* list, char* element)
+  {
+    int                 size;
+
+    /* we always keep one slot for the terminating NULL */
+    if (list -> count + 1 >= list -> size)
+      {
+        size = list -> size * 2;
+        list -> item = memRealloc(__FILE__, __LINE__, list -> item,
+            sizeof(char*) * list -> size,
+            sizeof(char*) * size);
+        list -> size = size;
+      }
+
+    list -> item[list -> count] = memAlloc(__FILE__, __LINE__,
+        strlen(element) + 1);
+    strStrncpy(list -> item[list -> count], element, strlen(element) + 1);
+    list -> item[++list -> count] = NULL;
+  }
+
+
 /* #############################################################################
  *
  * Description    count the entries in the list
@@ -92,6 +129,29 @@ int listCount(char** list)
   }
 
 
+/* #############################################################################
+ *
+ * Description    create a new and empty list
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         LIST* the new list
+ */
+LIST* listCreate(void)
+  {
+    LIST*               list;
+
+    list = memAlloc(__FILE__, __LINE__, sizeof(LIST));
+    list -> count = 0;
+    list -> size = LIST_MINSIZE;
+    list -> item = memAlloc(__FILE__, __LINE__,
+        sizeof(char*) * list -> size);
+    list -> item[0] = NULL;
+
+    return list;
+  }
+
+
 /* #############################################################################
  *
  * Description    delete the given element id from the list
@@ -136,6 +196,31 @@ char** listDelete(char** list, int id)
   }
 
 
+/* #############################################################################
+ *
+ * Description    free a list created with listCreate() and all its elements
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      LIST* list    - list to free
+ * Return         LIST* NULL
+ */
+LIST* listDestroy(LIST* list)
+  {
+    int                 id;
+
+    if (!list)
+      { return NULL; }
+
+    for (id = 0; id < list -> count; id++)
+      { memFreeString(__FILE__, __LINE__, list -> item[id]); }
+
+    memFree(__FILE__, __LINE__, list -> item, sizeof(char*) * list -> size);
+    memFree(__FILE__, __LINE__, list, sizeof(LIST));
+
+    return NULL;
+  }
+
+
 /* #############################################################################
  *
  * Description    free the whole list structure
@@ -164,6 +249,52 @@ char** listFree(char** list)
   }
 
 
+/* #############################################################################
+ *
+ * Description    remove the last element of the list
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      LIST* list    - list to modify
+ * Return         void
+ */
+void listPop(LIST* list)
+  {
+    if (!list -> count)
+      { return; }
+
+    list -> count--;
+    memFreeString(__FILE__, __LINE__, list -> item[list -> count]);
+    list -> item[list -> count] = NULL;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    remove the given element id from the list; the array is
+ *                not shrunk since the list most likely grows again
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      LIST* list    - list to modify
+ *                int id        - id of the element
+ * Return         void
+ */
+void listRemove(LIST* list, int id)
+  {
+    if (id < 0 ||
+        id >= list -> count)
+      { return; }
+
+    memFreeString(__FILE__, __LINE__, list -> item[id]);
+
+    /* we move all elements including the terminating NULL one id towards
+     * the beginning of the array
+     */
+    memmove(list -> item + id, list -> item + id + 1,
+        sizeof(char*) * (list -> count - id));
+    list -> count--;
+  }
+
+
 /* #############################################################################
  *
  * Description    sort the list
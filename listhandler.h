@@ -23,13 +23,30 @@
 #ifndef CPM_LISTHANDLER_H
 #define CPM_LISTHANDLER_H
 
+/* #############################################################################
+ * global variables
+ */
+typedef struct sList LIST;
+struct sList
+  {
+    char**              item;     /* NULL terminated view of the list */
+    int                 count,
+                        size;
+  };
+
+
 /* #############################################################################
  * prototypes
  */
 char** listAdd(char** list, char*  element);
+void listAppend(LIST* list, char* element);
 int listCount(char** list);
+LIST* listCreate(void);
 char** listDelete(char** list, int id);
+LIST* listDestroy(LIST* list);
 char** listFree(char** list);
+void listPop(LIST* list);
+void listRemove(LIST* list, int id);
 void listSort(char** list);
 
 
@@ -31,7 +31,50 @@
 /* #############################################################################
  * global variables
  */
-long int                memorycounter = 0;
+#ifndef MAP_ANONYMOUS
+  #define MAP_ANONYMOUS   MAP_ANON
+#endif
+#define ARENA_ALIGN       16
+#define ARENA_BLOCKSIZE   16384
+#define ARENA_HEADER      ((sizeof(MEMARENABLOCK) + ARENA_ALIGN - 1) & \
+                            ~(size_t)(ARENA_ALIGN - 1))
+
+typedef struct sMemArenaBlock MEMARENABLOCK;
+struct sMemArenaBlock
+  {
+    MEMARENABLOCK*      next;
+    size_t              size;
+    size_t              used;
+  };
+
+struct sMemArena
+  {
+    MEMARENABLOCK*      block;
+    size_t              blocksize;
+  };
+
+long int                memorycounter = 0,
+                        memorycalls = 0;
+
+/* the CLI search allocates from several threads at once */
+#ifdef __GNUC__
+  #define memCounterAdd(size) \
+      __atomic_add_fetch(&memorycounter, (long int)(size), __ATOMIC_RELAXED)
+  #define memCallsAdd() \
+      __atomic_add_fetch(&memorycalls, 1, __ATOMIC_RELAXED)
+#else
+  #define memCounterAdd(size) \
+      (memorycounter += (long int)(size))
+  #define memCallsAdd() \
+      (memorycalls++)
+#endif
+
+
+/* #############################################################################
+ * internal functions
+ */
+static void memArenaBlockFree(MEMARENABLOCK* block);
+static MEMARENABLOCK* memArenaBlockNew(size_t size);
 
 
 /* #############################################################################
@@ -103,6 +146,207 @@ void* memDebugRealloc(const char* file, int line, void* ptr, int size_old,
   }
 
 
+/* #############################################################################
+ *
+ * Description    allocate memory from an arena; the memory is zeroed, locked
+ *                against swapping and must not be freed on its own, it is
+ *                released with the whole arena
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      MEMARENA* arena - arena to allocate from
+ *                size_t size     - size of the area to allocate
+ * Return         pointer to the allocated memory
+ */
+void* memArenaAlloc(MEMARENA* arena, size_t size)
+  {
+    MEMARENABLOCK*      block;
+    void*               ptr;
+
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    block = arena -> block;
+    if (block -> used + size > block -> size)
+      {   /* the current block is full, we chain a new one in front of it */
+        block = memArenaBlockNew(size > arena -> blocksize ?
+            size : arena -> blocksize);
+        block -> next = arena -> block;
+        arena -> block = block;
+      }
+
+    ptr = (char*)block + ARENA_HEADER + block -> used;
+    block -> used += size;
+
+    return ptr;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    wipe and release one memory block of an arena
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      MEMARENABLOCK* block  - block to release
+ * Return         void
+ */
+static void memArenaBlockFree(MEMARENABLOCK* block)
+  {
+    size_t              size = ARENA_HEADER + block -> size;
+
+    memSet((char*)block + ARENA_HEADER, 0, block -> used);
+
+    /* update the memory counter */
+    memCounterAdd(-(long int)size);
+
+#ifndef NO_MEMLOCK
+    munlock(block, size);
+#endif
+    munmap(block, size);
+  }
+
+
+/* #############################################################################
+ *
+ * Description    map a new memory block for an arena; the block is page
+ *                aligned, so it can be locked without touching any other
+ *                allocation
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      size_t size - minimum usable size of the block
+ * Return         pointer to the new block
+ */
+static MEMARENABLOCK* memArenaBlockNew(size_t size)
+  {
+    MEMARENABLOCK*      block;
+    size_t              pagesize = sysconf(_SC_PAGESIZE);
+
+    size = (ARENA_HEADER + size + pagesize - 1) & ~(pagesize - 1);
+
+    block = mmap(NULL, size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (block == MAP_FAILED)
+      {
+        fprintf(stderr, _("out of memory error - tried to allocate %lu byte.\n"),
+            size);
+        exit(1);
+      }
+
+#ifndef NO_MEMLOCK
+    /* if we can't lock the block, it still is as safe as any other memory
+     * we allocate
+     */
+    mlock(block, size);
+#endif
+#ifdef MADV_DONTDUMP
+    madvise(block, size, MADV_DONTDUMP);
+#endif
+
+    /* update the memory counter */
+    memCounterAdd(size);
+
+    block -> next = NULL;
+    block -> size = size - ARENA_HEADER;
+    block -> used = 0;
+
+    return block;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    create a new memory arena; an arena hands out memory with a
+ *                simple bump pointer and wipes and releases everything at
+ *                once, which makes it the right choice for the many small
+ *                strings of one search run or screen update
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      size_t size - size of the arena blocks, 0 for the default
+ * Return         pointer to the new arena
+ */
+MEMARENA* memArenaCreate(size_t size)
+  {
+    MEMARENA*           arena;
+
+    arena = memRealAlloc(sizeof(MEMARENA));
+    arena -> blocksize = size ? size : ARENA_BLOCKSIZE;
+    arena -> block = memArenaBlockNew(arena -> blocksize);
+
+    return arena;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    wipe and release an arena and all memory allocated from it
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      MEMARENA* arena - arena to free
+ * Return         void
+ */
+void memArenaFree(MEMARENA* arena)
+  {
+    MEMARENABLOCK*      next;
+
+    if (!arena)
+      { return; }
+
+    while (arena -> block)
+      {
+        next = arena -> block -> next;
+        memArenaBlockFree(arena -> block);
+        arena -> block = next;
+      }
+
+    memRealFree(arena, sizeof(MEMARENA));
+  }
+
+
+/* #############################################################################
+ *
+ * Description    wipe all memory allocated from an arena and make it available
+ *                again; only the most recent block is kept
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      MEMARENA* arena - arena to reset
+ * Return         void
+ */
+void memArenaReset(MEMARENA* arena)
+  {
+    MEMARENABLOCK*      next;
+
+    while (arena -> block -> next)
+      {
+        next = arena -> block -> next -> next;
+        memArenaBlockFree(arena -> block -> next);
+        arena -> block -> next = next;
+      }
+
+    memSet((char*)arena -> block + ARENA_HEADER, 0, arena -> block -> used);
+    arena -> block -> used = 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    copy a string into an arena
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      MEMARENA* arena     - arena to allocate from
+ *                const char* string  - string to copy
+ * Return         pointer to the copy
+ */
+char* memArenaString(MEMARENA* arena, const char* string)
+  {
+    char*               ptr;
+    size_t              size = strlen(string) + 1;
+
+    ptr = memArenaAlloc(arena, size);
+    /* Flawfinder: ignore */
+    memcpy(ptr, string, size);
+
+    return ptr;
+  }
+
+
 /* #############################################################################
  *
  * Description    allocate memory of the given size
@@ -124,7 +368,8 @@ void* memRealAlloc(size_t size)
       }
 
     /* update the memory counter */
-    memorycounter += size;
+    memCounterAdd(size);
+    memCallsAdd();
 
     return ptr;
   }
@@ -144,6 +389,20 @@ long int memCheck(void)
   }
 
 
+/* #############################################################################
+ *
+ * Description    get the number of allocations and reallocations so far
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         number of calls
+ */
+long int memCalls(void)
+  {
+    return memorycalls;
+  }
+
+
 /* #############################################################################
  *
  * Description    free the given memory block
@@ -159,7 +418,7 @@ void memRealFree(void* ptr, size_t size)
       { return; }
 
     /* update the memory counter */
-    memorycounter -= size;
+    memCounterAdd(-(long int)size);
 
     memSet(ptr, 0, size);
 
@@ -206,8 +465,8 @@ void* memRealRealloc(void* ptr, size_t size_old, size_t size_new)
       }
 
     /* update the memory counter */
-    memorycounter -= size_old;
-    memorycounter += size_new;
+    memCounterAdd((long int)size_new - (long int)size_old);
+    memCallsAdd();
 
     return ptr;
   }
@@ -218,23 +477,57 @@ void* memRealRealloc(void* ptr, size_t size_old, size_t size_new)
  * Description    memset which should not get optimized by any compiler; using
  *                this function, a 'dead store removal' problem should not
  *                occur;
- *                this code was taken from 'Secure Programming for Linux and
+ *                the libc's explicit_bzero() or memset_explicit() are used if
+ *                available, otherwise a plain memset() is followed by a
+ *                compiler barrier which makes the stores visible; without gcc
+ *                the memory is written word by word through a volatile
+ *                pointer as described in 'Secure Programming for Linux and
  *                Unix HOWTO' p. 129 ff.
  * Author         Harry Brueckner
  * Date           2005-05-17
  * Arguments      void* ptr     - pointer to the array
  *                int value     - value to set
  *                size_t size   - size of the array
- * Return         pointer to the allocated memory
+ * Return         pointer to the array
  */
 void* memSet(void* ptr, int value, size_t size)
   {
-    volatile char*      p = ptr;
+#if defined(HAVE_MEMSET_EXPLICIT)
+    return memset_explicit(ptr, value, size);
+#else
+  #if defined(HAVE_EXPLICIT_BZERO)
+    if (!value)
+      {
+        explicit_bzero(ptr, size);
+        return ptr;
+      }
+  #endif
+  #if defined(__GNUC__)
+    memset(ptr, value, size);
+    __asm__ __volatile__("" : : "r" (ptr) : "memory");
+  #else
+    volatile unsigned char* p = ptr;
+    volatile unsigned long* w;
+    unsigned long       word;
+
+    while (size && (unsigned long)p % sizeof(unsigned long))
+      {
+        *p++ = value;
+        size--;
+      }
+
+    memset(&word, value, sizeof(word));
+    w = (volatile unsigned long*)p;
+    for (; size >= sizeof(unsigned long); size -= sizeof(unsigned long))
+      { *w++ = word; }
 
+    p = (volatile unsigned char*)w;
     while (size--)
       { *p++ = value; }
+  #endif
 
     return ptr;
+#endif
   }
 
 
@@ -23,6 +23,12 @@
 #ifndef CPM_MEMORY_H
 #define CPM_MEMORY_H
 
+/* #############################################################################
+ * global variables
+ */
+typedef struct sMemArena MEMARENA;
+
+
 /* #############################################################################
  * prototypes
  */
@@ -52,7 +58,14 @@ void memDebugFreeString(const char* file, int line, void* ptr);
 void* memDebugRealloc(const char* file, int line, void* ptr, int size_old,
     int size_new);
 
+void* memArenaAlloc(MEMARENA* arena, size_t size);
+MEMARENA* memArenaCreate(size_t size);
+void memArenaFree(MEMARENA* arena);
+void memArenaReset(MEMARENA* arena);
+char* memArenaString(MEMARENA* arena, const char* string);
+
 void* memRealAlloc(size_t size);
+long int memCalls(void);
 long int memCheck();
 void memRealFree(void* ptr, size_t size);
 void memRealFreeString(char* ptr);
@@ -40,6 +40,9 @@
 #ifdef HAVE_LIBZ
   #include <zlib.h>
 #endif
+#ifdef HAVE_LIBZSTD
+  #include <zstd.h>
+#endif
 #include <gpgme.h>
 #include "configuration.h"
 #include "general.h"
@@ -189,6 +192,11 @@ int getOptions(int argc, char **argv)
             { "security",     no_argument,        0, 0 },   /* 14 */
             { "testrun",      optional_argument,  0, 0 },   /* 15 */
             { "version",      no_argument,        0, 0 },   /* 16 */
+            { "agent",        no_argument,        0, 0 },   /* 17 */
+            { "batch",        no_argument,        0, 0 },   /* 18 */
+            { "null",         no_argument,        0, 0 },   /* 19 */
+            { "prefix",       no_argument,        0, 0 },   /* 20 */
+            { "substring",    no_argument,        0, 0 },   /* 21 */
             { 0,              0,                  0, 0 }
           };
 
@@ -257,6 +265,21 @@ int getOptions(int argc, char **argv)
                 case 16:   /* version */
                     config -> version = 1;
                     break;
+                case 17:   /* agent */
+                    config -> agent = 1;
+                    break;
+                case 18:   /* batch */
+                    config -> batch = 1;
+                    break;
+                case 19:   /* null */
+                    config -> batchdelimiter = 0;
+                    break;
+                case 20:   /* prefix */
+                    runtime -> searchtype = SEARCH_PREFIX;
+                    break;
+                case 21:   /* substring */
+                    runtime -> searchtype = SEARCH_SUBSTRING;
+                    break;
                 case 15:   /* testrun */
 #ifdef TEST_OPTION
                     if (!optarg)
@@ -427,6 +450,8 @@ int getOptions(int argc, char **argv)
 
     /* find out wether we run in CLI or GUI mode */
     if (config -> searchdata ||
+        config -> agent ||
+        config -> batch ||
 #ifdef TEST_OPTION
         config -> testrun)
 #else
@@ -453,6 +478,10 @@ void showHelp(void)
     TRACE(99, "showHelp()", NULL);
 
     printf(_("usage: cpm [--config FILE] [--help] [PATH] ...\n"));
+    printf(_("    --agent         keep the database loaded and answer the searches of\n"));
+    printf(_("                    other cli calls until AgentTimeout seconds pass idle\n"));
+    printf(_("    --batch         read one search per line from stdin and answer each with\n"));
+    printf(_("                    its results and an empty line\n"));
     printf(_("    --config, -c    configuration file to use [~/%s]\n"),
         DEFAULT_RC_FILE);
     printf(_("    --configtest    verify the configuration file and exit\n"));
@@ -471,19 +500,26 @@ void showHelp(void)
     printf(_("    --noencryption  turn off file encryption\n"));
     printf(_("                    WARNING: THIS IS FOR DEVELOPMENT AND TESTING ONLY!\n"));
     printf(_("    --noignore      search case sensitive in cli mode\n"));
+    printf(_("    --null          --batch queries and results are separated by NUL\n"));
+    printf(_("    --prefix        search for the start of the results in cli mode\n"));
     printf(_("    --readonly      open the database in read-only mode\n"));
     printf(_("    --regex, -r     search with regular expressions in cli mode\n"));
     printf(_("    --regular       use regular search in cli mode\n"));
     printf(_("    --security, -s  run a security check and show the current security status\n"));
+    printf(_("    --substring     search for any part of the results in cli mode\n"));
 #ifdef TEST_OPTION
     printf(_("    --testrun       run one of the testmodes\n"));
     printf(_("                    backup        - run test on the backupfile creation\n"));
-    printf(_("                    compress[1-6] - run compression test 1-6\n"));
+    printf(_("                    compress      - run the benchmark of the compression codecs\n"));
+    printf(_("                    compressN     - run compression test N (1-10)\n"));
     printf(_("                    decrypt       - run test on the decryption code\n"));
     printf(_("                    encrypt       - run test on the encryption code\n"));
     printf(_("                    environment   - run test on the environment validation\n"));
     printf(_("                    garbage       - run test on garbage input files\n"));
+    printf(_("                    memset        - run test on the memory wiping\n"));
+    printf(_("                    regex         - run test on the regular expression engines\n"));
     printf(_("                    searchpattern - run test on the search patterns\n"));
+    printf(_("                    treewalk      - run test on walking deep trees\n"));
 #endif
     printf(_("    --version       display the version and exit\n"));
     printf(_("    PATH            path to display the password for\n"));
@@ -543,6 +579,9 @@ void showVersion(void)
 #endif
     printf(_("XML2 version %s.\n"), LIBXML_DOTTED_VERSION);
     printf(_("zlib version %s.\n"), ZLIB_VERSION);
+#ifdef HAVE_LIBZSTD
+    printf(_("zstd version %s.\n"), ZSTD_versionString());
+#endif
 #ifdef HAVE_CRACKLIB
     printf(_("cracklib is enabled.\n"));
 #else
@@ -26,6 +26,7 @@
  */
 #include "cpm.h"
 #include "configuration.h"
+#include "dfa.h"
 #include "general.h"
 #include "interface_xml.h"
 #include "listhandler.h"
@@ -39,15 +40,24 @@
  */
 SEARCHPATTERN**         patterndata;
 SEARCHPATTERN**         resultdata;
-int                     patterncount;
+PATTERNPLAN**           plandata;
+int                     patterncount,
+                        patternparts;
 
 
 /* #############################################################################
  * internal functions
  */
-int getPatternString(SEARCHPATTERN* pattern, char** path, char** string);
+char* getPatternPart(SEARCHPATTERN* pattern, char** path);
+int getPatternString(SEARCHPATTERN* pattern, WALKPATH* path,
+    char** string, MEMARENA* arena);
 int patternCreate(char* patternstring, SEARCHPATTERN* pattern);
 void patternDump(SEARCHPATTERN* pattern);
+char* patternPartString(PATTERNPLAN* plan, int part, char** path,
+    int casesensitive, int* size);
+PATTERNPLAN* patternPlanCreate(SEARCHPATTERN* pattern);
+void patternPlanFree(PATTERNPLAN* plan);
+int patternPlanShared(PATTERNPLAN* plan, PATTERNPLAN* other);
 int patternTemplateId(char* template);
 
 
@@ -99,12 +109,40 @@ void freePatternparser(void)
                 memFree(__FILE__, __LINE__, cur, sizeof(SEARCHPATTERN));
                 cur = next;
               }
+
+            patternPlanFree(plandata[i]);
           }
 
         memFree(__FILE__, __LINE__,
             patterndata, sizeof(SEARCHPATTERN*) * patterncount);
         memFree(__FILE__, __LINE__,
             resultdata, sizeof(SEARCHPATTERN*) * patterncount);
+        memFree(__FILE__, __LINE__,
+            plandata, sizeof(PATTERNPLAN*) * patterncount);
+      }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    get the string one pattern element stands for
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      SEARCHPATTERN pattern   - pattern element
+ *                char** path             - path information to fill into the
+ *                                          pattern
+ * Return         the string or NULL if the element has none
+ */
+char* getPatternPart(SEARCHPATTERN* pattern, char** path)
+  {
+    switch (pattern -> type)
+      {
+        case PATTERN_TEMPLATE:
+            return path[pattern -> templateid - 1];
+        case PATTERN_STRING:
+            return pattern -> string;
+        default:
+            return NULL;
       }
   }
 
@@ -114,17 +152,19 @@ void freePatternparser(void)
  * Description    get a specific result pattern filled out
  * Author         Harry Brueckner
  * Date           2005-04-12
- * Arguments      int id        - id of the search pattern
- *                char** path   - path information to full into the pattern
- *                char* string  - result string which must be freed by the
- *                                caller
+ * Arguments      int id          - id of the search pattern
+ *                WALKPATH* path  - path information to full into the pattern
+ *                char* string    - result string which must be freed by the
+ *                                  caller unless it comes from an arena
+ *                MEMARENA* arena - arena to allocate the string from or NULL
  * Return         1 on error, 0 if ok
  */
-int getPatternResultString(int id, char** path, char** string)
+int getPatternResultString(int id, WALKPATH* path, char** string,
+    MEMARENA* arena)
   {
     TRACE(99, "getPatternResultString()", NULL);
 
-    return getPatternString(resultdata[id], path, string);
+    return getPatternString(resultdata[id], path, string, arena);
   }
 
 
@@ -133,77 +173,98 @@ int getPatternResultString(int id, char** path, char** string)
  * Description    get a specific search pattern filled out
  * Author         Harry Brueckner
  * Date           2005-04-12
- * Arguments      int id        - id of the search pattern
- *                char** path   - path information to full into the pattern
- *                char* string  - result string which must be freed by the
- *                                caller
+ * Arguments      int id          - id of the search pattern
+ *                WALKPATH* path  - path information to full into the pattern
+ *                char* string    - result string which must be freed by the
+ *                                  caller unless it comes from an arena
+ *                MEMARENA* arena - arena to allocate the string from or NULL
  * Return         1 on error, 0 if ok
  */
-int getPatternSearchString(int id, char** path, char** string)
+int getPatternSearchString(int id, WALKPATH* path, char** string,
+    MEMARENA* arena)
   {
     TRACE(99, "getPatternSearchString()", NULL);
 
-    return getPatternString(patterndata[id], path, string);
+    return getPatternString(patterndata[id], path, string, arena);
   }
 
 
 /* #############################################################################
  *
  * Description    create a string from a searchpattern and path information
+ *                in the terminal encoding
  * Author         Harry Brueckner
  * Date           2005-04-12
  * Arguments      SEARCHPATTERN pattern   - pattern to create
- *                char** path             - path information to full into the
+ *                WALKPATH* path          - path information to full into the
  *                                          pattern
  *                char* string            - result string which must be freed
- *                                          by the caller
+ *                                          by the caller unless it comes from
+ *                                          an arena
+ *                MEMARENA* arena         - arena to allocate the string from
+ *                                          or NULL
  * Return         1 on error, 0 if ok
  */
-int getPatternString(SEARCHPATTERN* pattern, char** path, char** string)
+int getPatternString(SEARCHPATTERN* pattern, WALKPATH* path,
+    char** string, MEMARENA* arena)
   {
-    SEARCHPATTERN*      cpattern = pattern;
-    int                 maxlevel = listCount(path);
+    SEARCHPATTERN*      cpattern;
+    int                 maxlevel = path -> depth,
+                        parts = 0,
+                        size = 0;
     char*               concat;
+    char*               ptr;
 
     TRACE(99, "getPatternString()", NULL);
 
     *string = NULL;
+
+    /* we first calculate the size of the result, so we need only a single
+     * allocation
+     */
+    cpattern = pattern;
     while (cpattern)
       {
-        switch (cpattern -> type)
+        if (cpattern -> type == PATTERN_TEMPLATE &&
+            cpattern -> templateid > maxlevel)
+          { return 1; }
+
+        concat = getPatternPart(cpattern, path -> terminal);
+        if (concat)
           {
-            case PATTERN_TEMPLATE:
-                if (cpattern -> templateid > maxlevel)
-                  { return 1; }
-                concat = path[cpattern -> templateid - 1];
-                break;
-            case PATTERN_STRING:
-                concat = cpattern -> string;
-                break;
-            default:
-                concat = NULL;
+            size += strlen(concat);
+            parts++;
           }
+        else if (cpattern -> type == PATTERN_TEMPLATE)
+          { return 1; }   /* the label can't be displayed */
 
-        if (concat)
-          {   /* we have a string to concat to the result */
-            if (!*string)
-              {   /* new string */
-                *string = memAlloc(__FILE__, __LINE__, strlen(concat) + 1);
-                *string[0] = 0;
-              }
-            else
-              {   /* resize the string */
-                *string = memRealloc(__FILE__, __LINE__,
-                    *string,
-                    strlen(*string) + 1,
-                    strlen(*string) + strlen(concat) + 1);
-              }
+        cpattern = cpattern -> next;
+      }
+
+    if (!parts)
+      { return 0; }
+
+    if (arena)
+      { *string = memArenaAlloc(arena, size + 1); }
+    else
+      { *string = memAlloc(__FILE__, __LINE__, size + 1); }
 
-            strStrncat(*string, concat, strlen(concat) + 1);
+    ptr = *string;
+    cpattern = pattern;
+    while (cpattern)
+      {
+        concat = getPatternPart(cpattern, path -> terminal);
+        if (concat)
+          {
+            size = strlen(concat);
+            /* Flawfinder: ignore */
+            memcpy(ptr, concat, size);
+            ptr += size;
           }
 
         cpattern = cpattern -> next;
       }
+    *ptr = 0;
 
     return 0;
   }
@@ -222,8 +283,10 @@ void initPatternparser(void)
     TRACE(99, "initPatternparser()", NULL);
 
     patterndata = NULL;
+    plandata = NULL;
     resultdata = NULL;
     patterncount = 0;
+    patternparts = 0;
   }
 
 
@@ -438,6 +501,98 @@ void patternDump(SEARCHPATTERN* pattern)
   }
 
 
+/* #############################################################################
+ *
+ * Description    find out if a pattern filled out with the path matches the
+ *                query; a case insensitive search compares the folded labels
+ *                with the folded query, so both searches compare bytes only
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      int id                - id of the search pattern
+ *                WALKPATH* path        - path information for the pattern
+ *                const char* query     - the string to search for; it must
+ *                                        be folded for a case insensitive
+ *                                        search
+ *                int type              - SEARCH_REGULAR for the whole
+ *                                        string, SEARCH_PREFIX for its start
+ *                                        or SEARCH_SUBSTRING for any part
+ *                int casesensitive     - 1 for a case sensitive comparison
+ *                MEMARENA* arena       - arena for the string of a substring
+ *                                        search
+ * Return         1 if the pattern matches the query, otherwise 0
+ */
+int patternMatch(int id, WALKPATH* path, const char* query, int type,
+    int casesensitive, MEMARENA* arena)
+  {
+    PATTERNPLAN*        plan = plandata[id];
+    int                 depth = path -> depth,
+                        i,
+                        position = 0,
+                        querysize,
+                        size;
+    char**              labels = (casesensitive) ? path -> label : path -> folded;
+    char*               buffer;
+    char*               string;
+
+    TRACE(99, "patternMatch()", NULL);
+
+    if (!plan -> parts ||
+        plan -> maxtemplate > depth)
+      { return 0; }
+
+    querysize = strlen(query);
+    if (type == SEARCH_SUBSTRING)
+      {   /* we need the whole string to search in it */
+        for (i = 0; i < plan -> parts; i++)
+          {
+            patternPartString(plan, i, path -> label, 1, &size);
+            position += size;
+          }
+        if (position < querysize)
+          { return 0; }
+
+        buffer = memArenaAlloc(arena, position + 1);
+        for (i = 0, position = 0; i < plan -> parts; i++)
+          {
+            string = patternPartString(plan, i, labels, casesensitive, &size);
+            /* Flawfinder: ignore */
+            memcpy(buffer + position, string, size);
+            position += size;
+          }
+
+        return (strFind(buffer, position, query, querysize) != NULL);
+      }
+
+    if (type == SEARCH_REGULAR &&
+        plan -> minlength > querysize)
+      { return 0; }
+
+    for (i = 0; i < plan -> parts; i++)
+      {
+        string = patternPartString(plan, i, labels, casesensitive, &size);
+        if (type == SEARCH_PREFIX)
+          {   /* the query may end within this part */
+            size = min(size, querysize - position);
+            if (memcmp(query + position, string, size))
+              { return 0; }
+
+            position += size;
+            if (position == querysize)
+              { return 1; }
+            continue;
+          }
+
+        if (position + size > querysize ||
+            memcmp(query + position, string, size))
+          { return 0; }
+
+        position += size;
+      }
+
+    return (position == querysize);
+  }
+
+
 /* #############################################################################
  *
  * Description    parse the defined patterns for later use
@@ -449,7 +604,9 @@ void patternDump(SEARCHPATTERN* pattern)
 int patternParse(void)
   {
     int                 error = 0,
-                        i;
+                        i,
+                        j,
+                        parts;
 
     TRACE(99, "patternParse()", NULL);
 
@@ -458,6 +615,8 @@ int patternParse(void)
         sizeof(SEARCHPATTERN*) * patterncount);
     resultdata = memAlloc(__FILE__, __LINE__,
         sizeof(SEARCHPATTERN*) * patterncount);
+    plandata = memAlloc(__FILE__, __LINE__,
+        sizeof(PATTERNPLAN*) * patterncount);
 
     for (i = 0; i < patterncount; i++)
       {
@@ -480,12 +639,379 @@ int patternParse(void)
 
         if (patternCreate(runtime -> resultpatterns[i], resultdata[i]))
           { error = 1; }
+
+        plandata[i] = patternPlanCreate(patterndata[i]);
+      }
+
+    /* a pattern which starts with the same parts as an earlier one can
+     * continue a regular expression search where the earlier one stopped
+     */
+    patternparts = 0;
+    for (i = 0; i < patterncount; i++)
+      {
+        plandata[i] -> first = patternparts;
+        patternparts += plandata[i] -> parts;
+
+        for (j = 0; j < i; j++)
+          {
+            parts = patternPlanShared(plandata[i], plandata[j]);
+            if (parts > plandata[i] -> sharedparts)
+              {
+                plandata[i] -> shared = j;
+                plandata[i] -> sharedparts = parts;
+              }
+          }
       }
 
     return error;
   }
 
 
+/* #############################################################################
+ *
+ * Description    get the number of parts of all search patterns
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         int the number of parts
+ */
+int patternPartCount(void)
+  {
+    TRACE(99, "patternPartCount()", NULL);
+
+    return patternparts;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    get the string of one part of a compiled pattern
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      PATTERNPLAN* plan   - the compiled pattern
+ *                int part            - id of the part
+ *                char** path         - path information for the pattern
+ *                int casesensitive   - 0 to get the folded fixed strings
+ *                int* size           - length of the string
+ * Return         char* the string or NULL if the label of the path is missing
+ */
+char* patternPartString(PATTERNPLAN* plan, int part, char** path,
+    int casesensitive, int* size)
+  {
+    char*               string;
+
+    if (plan -> length[part] >= 0)
+      {
+        *size = plan -> length[part];
+        return (casesensitive) ?
+            plan -> part[part] -> string : plan -> folded[part];
+      }
+
+    string = path[plan -> part[part] -> templateid - 1];
+    if (!string)
+      {   /* the label can't be converted into the terminal encoding */
+        *size = 0;
+        return NULL;
+      }
+    *size = strlen(string);
+
+    return string;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    compile a search pattern into a plan which lists its parts
+ *                in an array together with the length of all fixed strings
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      SEARCHPATTERN* pattern  - the pattern to compile
+ * Return         PATTERNPLAN* the compiled pattern
+ */
+PATTERNPLAN* patternPlanCreate(SEARCHPATTERN* pattern)
+  {
+    PATTERNPLAN*        plan;
+    SEARCHPATTERN*      cur;
+    int                 i = 0;
+
+    TRACE(99, "patternPlanCreate()", NULL);
+
+    plan = memAlloc(__FILE__, __LINE__, sizeof(PATTERNPLAN));
+    plan -> part = NULL;
+    plan -> folded = NULL;
+    plan -> length = NULL;
+    plan -> first = 0;
+    plan -> maxtemplate = 0;
+    plan -> minlength = 0;
+    plan -> parts = 0;
+    plan -> shared = 0;
+    plan -> sharedparts = 0;
+
+    for (cur = pattern; cur; cur = cur -> next)
+      {
+        if (cur -> type == PATTERN_STRING ||
+            cur -> type == PATTERN_TEMPLATE)
+          { plan -> parts++; }
+      }
+
+    if (!plan -> parts)
+      { return plan; }
+
+    plan -> part = memAlloc(__FILE__, __LINE__,
+        plan -> parts * sizeof(SEARCHPATTERN*));
+    plan -> folded = memAlloc(__FILE__, __LINE__,
+        plan -> parts * sizeof(char*));
+    plan -> length = memAlloc(__FILE__, __LINE__,
+        plan -> parts * sizeof(int));
+
+    for (cur = pattern; cur; cur = cur -> next)
+      {
+        if (cur -> type == PATTERN_STRING)
+          {
+            plan -> part[i] = cur;
+            plan -> length[i] = strlen(cur -> string);
+            plan -> folded[i] = memAlloc(__FILE__, __LINE__,
+                plan -> length[i] + 1);
+            strFold(plan -> folded[i], cur -> string);
+            plan -> minlength += plan -> length[i];
+            i++;
+          }
+        else if (cur -> type == PATTERN_TEMPLATE)
+          {
+            plan -> part[i] = cur;
+            plan -> folded[i] = NULL;
+            plan -> length[i] = -1;
+            plan -> maxtemplate = max(plan -> maxtemplate, cur -> templateid);
+            i++;
+          }
+      }
+
+    return plan;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    free a compiled pattern
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      PATTERNPLAN* plan   - the compiled pattern
+ * Return         void
+ */
+void patternPlanFree(PATTERNPLAN* plan)
+  {
+    int                 i;
+
+    TRACE(99, "patternPlanFree()", NULL);
+
+    if (!plan)
+      { return; }
+
+    if (plan -> parts)
+      {
+        for (i = 0; i < plan -> parts; i++)
+          { memFreeString(__FILE__, __LINE__, plan -> folded[i]); }
+        memFree(__FILE__, __LINE__, plan -> folded,
+            plan -> parts * sizeof(char*));
+        memFree(__FILE__, __LINE__, plan -> part,
+            plan -> parts * sizeof(SEARCHPATTERN*));
+        memFree(__FILE__, __LINE__, plan -> length,
+            plan -> parts * sizeof(int));
+      }
+    memFree(__FILE__, __LINE__, plan, sizeof(PATTERNPLAN));
+  }
+
+
+/* #############################################################################
+ *
+ * Description    count the parts two compiled patterns start with
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      PATTERNPLAN* plan   - the first pattern
+ *                PATTERNPLAN* other  - the second pattern
+ * Return         int the number of equal parts at the start of both
+ */
+int patternPlanShared(PATTERNPLAN* plan, PATTERNPLAN* other)
+  {
+    SEARCHPATTERN*      part;
+    SEARCHPATTERN*      otherpart;
+    int                 i;
+
+    TRACE(99, "patternPlanShared()", NULL);
+
+    for (i = 0; i < plan -> parts && i < other -> parts; i++)
+      {
+        part = plan -> part[i];
+        otherpart = other -> part[i];
+        if (part -> type != otherpart -> type ||
+            (part -> type == PATTERN_TEMPLATE &&
+                part -> templateid != otherpart -> templateid) ||
+            (part -> type == PATTERN_STRING &&
+                strcmp(part -> string, otherpart -> string)))
+          { break; }
+      }
+
+    return i;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    find out if any node below the given path can still match
+ *                the query; all parts of the pattern which are already known
+ *                at this depth are compared from the start and from the end
+ *                of the query, so a subtree can be skipped as soon as one of
+ *                its fixed parts doesn't fit; a prefix can only be compared
+ *                from the start and a substring only once all parts are
+ *                known
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      int id                - id of the search pattern
+ *                WALKPATH* path        - path information for the pattern
+ *                const char* query     - the string to search for
+ *                int type              - type of the search, see
+ *                                        patternMatch()
+ *                int casesensitive     - 1 for a case sensitive comparison
+ *                MEMARENA* arena       - arena for the string of a substring
+ *                                        search
+ * Return         1 if no node below the path can match, otherwise 0
+ */
+int patternPrune(int id, WALKPATH* path, const char* query, int type,
+    int casesensitive, MEMARENA* arena)
+  {
+    PATTERNPLAN*        plan = plandata[id];
+    int                 depth = path -> depth,
+                        first,
+                        last,
+                        position = 0,
+                        querysize,
+                        size;
+    char**              labels = (casesensitive) ? path -> label : path -> folded;
+    char*               string;
+
+    TRACE(99, "patternPrune()", NULL);
+
+    if (!plan -> parts)
+      { return 1; }
+
+    /* if all parts are known, every node below creates the same string */
+    if (plan -> maxtemplate <= depth)
+      {
+        return !patternMatch(id, path, query, type, casesensitive, arena);
+      }
+
+    if (type == SEARCH_SUBSTRING)
+      { return 0; }
+
+    querysize = strlen(query);
+    if (type == SEARCH_REGULAR &&
+        plan -> minlength > querysize)
+      { return 1; }
+
+    /* we compare the known parts at the start of the pattern */
+    for (first = 0; first < plan -> parts; first++)
+      {
+        if (plan -> length[first] < 0 &&
+            plan -> part[first] -> templateid > depth)
+          { break; }
+
+        string = patternPartString(plan, first, labels, casesensitive, &size);
+        if (type == SEARCH_PREFIX)
+          {   /* once the query is used up, everything below matches */
+            size = min(size, querysize - position);
+            if (memcmp(query + position, string, size))
+              { return 1; }
+
+            position += size;
+            if (position == querysize)
+              { return 0; }
+            continue;
+          }
+
+        if (position + size > querysize ||
+            memcmp(query + position, string, size))
+          { return 1; }
+
+        position += size;
+      }
+
+    if (type == SEARCH_PREFIX)
+      { return 0; }
+
+    /* and the known parts at the end of the pattern */
+    for (last = plan -> parts - 1; last > first; last--)
+      {
+        if (plan -> length[last] < 0 &&
+            plan -> part[last] -> templateid > depth)
+          { break; }
+
+        string = patternPartString(plan, last, labels, casesensitive, &size);
+        if (position + size > querysize ||
+            memcmp(query + querysize - size, string, size))
+          { return 1; }
+
+        querysize -= size;
+      }
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    find out if a pattern filled out with the path matches a
+ *                compiled regular expression; the parts of the pattern are
+ *                taken in the terminal encoding one by one and run
+ *                through the DFA without building the string; the state
+ *                after each part is kept, so a pattern which starts with the
+ *                same parts as an earlier one continues where that one
+ *                stopped; the patterns of a path must therefore be matched
+ *                in the order of their ids after all states were set to -1
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      int id            - id of the search pattern
+ *                WALKPATH* path    - path information for the pattern
+ *                DFACACHE* cache   - the DFA cache of the thread
+ *                int* state        - the states of all parts of all
+ *                                    patterns, see patternPartCount()
+ * Return         1 if the pattern matches the expression, otherwise 0
+ */
+int patternRegexMatch(int id, WALKPATH* path, DFACACHE* cache, int* state)
+  {
+    PATTERNPLAN*        plan = plandata[id];
+    int                 current,
+                        i,
+                        size;
+    char*               string;
+
+    TRACE(99, "patternRegexMatch()", NULL);
+
+    if (!plan -> parts ||
+        plan -> maxtemplate > path -> depth)
+      { return 0; }
+
+    current = dfaStart(cache);
+    for (i = 0; i < plan -> parts; i++)
+      {
+        if (i < plan -> sharedparts &&
+            state[plandata[plan -> shared] -> first + i] >= 0)
+          { current = state[plandata[plan -> shared] -> first + i]; }
+        else
+          {
+            string = patternPartString(plan, i, path -> terminal, 1, &size);
+            if (!string)
+              { return 0; }
+
+            current = dfaFeed(cache, current, string, size);
+          }
+
+        state[plan -> first + i] = current;
+      }
+
+    return dfaFinish(cache, current);
+  }
+
+
 /* #############################################################################
  *
  * Description    find the id for the given template string
@@ -24,6 +24,14 @@
 #define CPM_PATTERNPARSER_H
 
 
+/* #############################################################################
+ * includes
+ */
+#include "dfa.h"
+#include "interface_xml.h"
+#include "memory.h"
+
+
 /* #############################################################################
  * global interface variables
  */
@@ -36,6 +44,20 @@ struct sSearchPattern
     SEARCHPATTERN*      next;
   };
 
+typedef struct sPatternPlan PATTERNPLAN;
+struct sPatternPlan
+  {
+    SEARCHPATTERN**     part;
+    char**              folded;   /* fixed strings with their case folded */
+    int*                length;
+    int                 first,    /* index of the first part in all parts */
+                        maxtemplate,
+                        minlength,
+                        parts,
+                        shared,   /* earlier pattern with the same start */
+                        sharedparts;
+  };
+
 #define PATTERN_UNDEF     0
 #define PATTERN_STRING    1
 #define PATTERN_TEMPLATE  2
@@ -45,10 +67,18 @@ struct sSearchPattern
  * prototypes
  */
 void freePatternparser(void);
-int getPatternResultString(int id, char** path, char** string);
-int getPatternSearchString(int id, char** path, char** string);
+int getPatternResultString(int id, WALKPATH* path, char** string,
+    MEMARENA* arena);
+int getPatternSearchString(int id, WALKPATH* path, char** string,
+    MEMARENA* arena);
 void initPatternparser(void);
+int patternMatch(int id, WALKPATH* path, const char* query, int type,
+    int casesensitive, MEMARENA* arena);
 int patternParse(void);
+int patternPartCount(void);
+int patternPrune(int id, WALKPATH* path, const char* query, int type,
+    int casesensitive, MEMARENA* arena);
+int patternRegexMatch(int id, WALKPATH* path, DFACACHE* cache, int* state);
 
 
 #endif
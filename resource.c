@@ -54,21 +54,27 @@ FUNC_ERRORHANDLER(errorHandler);
 static const configoption_t options[] =
   {
     { "AskToQuit",          ARG_TOGGLE, cbFlagArgument, NULL, CTX_ALL },
+    { "BinaryOutput",       ARG_TOGGLE, cbFlagArgument, NULL, CTX_ALL },
     { "CrackLibCheck",      ARG_TOGGLE, cbFlagArgument, NULL, CTX_ALL },
     { "CreateBackup",       ARG_TOGGLE, cbFlagArgument, NULL, CTX_ALL },
     { "KeepPassphrase",     ARG_TOGGLE, cbFlagArgument, NULL, CTX_ALL },
     { "MatchCaseSensitive", ARG_TOGGLE, cbFlagArgument, NULL, CTX_ALL },
     { "TemplateLock",       ARG_TOGGLE, cbFlagArgument, NULL, CTX_ALL },
 
+    { "AgentTimeout",       ARG_INT, cbIntArgument, NULL, CTX_ALL },
     { "Compression",        ARG_INT, cbIntArgument, NULL, CTX_ALL },
+    { "CompressionThreads", ARG_INT, cbIntArgument, NULL, CTX_ALL },
     { "InfoboxHeight",      ARG_INT, cbIntArgument, NULL, CTX_ALL },
     { "PasswordLength",     ARG_INT, cbIntArgument, NULL, CTX_ALL },
+    { "SearchThreads",      ARG_INT, cbIntArgument, NULL, CTX_ALL },
     { "InactiveTimeout",    ARG_INT, cbIntArgument, NULL, CTX_ALL }, 
 
+    { "CompressionType",    ARG_STR, cbStringArgument, NULL, CTX_ALL },
     { "DatabaseFile",       ARG_STR, cbStringArgument, NULL, CTX_ALL },
     { "EncryptionKey",      ARG_STR, cbStringArgument, NULL, CTX_ALL },
     { "HideCharacter",      ARG_STR, cbStringArgument, NULL, CTX_ALL },
     { "PasswordAlphabet",   ARG_STR, cbStringArgument, NULL, CTX_ALL },
+    { "RegexEngine",        ARG_STR, cbStringArgument, NULL, CTX_ALL },
     { "SearchType",         ARG_STR, cbStringArgument, NULL, CTX_ALL },
 
     { "SearchPattern",      ARG_LIST, cbListArgument, NULL, CTX_ALL },
@@ -90,6 +96,8 @@ static DOTCONF_CB(cbFlagArgument)
   {
     if (!strcmp(cmd -> name, "AskToQuit"))
       { config -> asktoquit = cmd -> data.value; }
+    else if (!strcmp(cmd -> name, "BinaryOutput"))
+      { config -> binaryoutput = cmd -> data.value; }
     else if (!strcmp(cmd -> name, "CrackLibCheck"))
       { config -> cracklibstatus = cmd -> data.value; }
     else if (!strcmp(cmd -> name, "CreateBackup"))
@@ -115,7 +123,14 @@ static DOTCONF_CB(cbFlagArgument)
  */
 static DOTCONF_CB(cbIntArgument)
   {
-    if (!strcmp(cmd -> name, "Compression"))
+    if (!strcmp(cmd -> name, "AgentTimeout"))
+      {
+        if (cmd -> data.value >= 0)
+          { config -> agenttimeout = cmd -> data.value; }
+        else
+          { return _("AgentTimeout must not be negative."); }
+      }
+    else if (!strcmp(cmd -> name, "Compression"))
       {
         if (cmd -> data.value >= Z_NO_COMPRESSION &&
             cmd -> data.value <= Z_BEST_COMPRESSION)
@@ -123,6 +138,13 @@ static DOTCONF_CB(cbIntArgument)
         else
           { config -> compression = Z_BEST_COMPRESSION; }
       }
+    else if (!strcmp(cmd -> name, "CompressionThreads"))
+      {
+        if (cmd -> data.value >= 0)
+          { config -> compressionthreads = cmd -> data.value; }
+        else
+          { return _("CompressionThreads must not be negative."); }
+      }
     else if (!strcmp(cmd -> name, "InfoboxHeight"))
       {
         if (cmd -> data.value < 5)
@@ -139,6 +161,13 @@ static DOTCONF_CB(cbIntArgument)
         else
           { return _("PasswordLength must be at least be 5."); }
       }
+    else if (!strcmp(cmd -> name, "SearchThreads"))
+      {
+        if (cmd -> data.value >= 0)
+          { config -> searchthreads = cmd -> data.value; }
+        else
+          { return _("SearchThreads must not be negative."); }
+      }
     else if (!strcmp(cmd -> name, "InactiveTimeout"))
       { config -> inactivetimeout = cmd -> data.value; }
 
@@ -217,6 +246,21 @@ static DOTCONF_CB(cbStringArgument)
   {
     if (strlen(cmd -> data.str) > STDSTRINGLENGTH)
       { return _("string argument too long."); }
+    else if (!strcmp(cmd -> name, "CompressionType"))
+      {
+        if (!strcmp("gzip", cmd -> data.str))
+          { config -> compressiontype = COMPRESSION_GZIP; }
+        else if (!strcmp("zstd", cmd -> data.str))
+          {
+#ifdef HAVE_LIBZSTD
+            config -> compressiontype = COMPRESSION_ZSTD;
+#else
+            return _("CompressionType zstd is not supported by this build.");
+#endif
+          }
+        else
+          { return _("Illegal value for resource CompressionType."); }
+      }
     else if (!strcmp(cmd -> name, "DatabaseFile"))
       {
         memFreeString(__FILE__, __LINE__, config -> dbfilerc);
@@ -248,12 +292,25 @@ static DOTCONF_CB(cbStringArgument)
                 strlen(cmd -> data.str) + 1);
           }
       }
+    else if (!strcmp(cmd -> name, "RegexEngine"))
+      {
+        if (!strcmp("posix", cmd -> data.str))
+          { config -> regexengine = REGEX_POSIX; }
+        else if (!strcmp("builtin", cmd -> data.str))
+          { config -> regexengine = REGEX_BUILTIN; }
+        else
+          { return _("Illegal value for resource RegexEngine."); }
+      }
     else if (!strcmp(cmd -> name, "SearchType"))
       {
         if (!strcmp("regex", cmd -> data.str))
           { config -> searchtype = SEARCH_REGEX; }
         else if (!strcmp("regular", cmd -> data.str))
           { config -> searchtype = SEARCH_REGULAR; }
+        else if (!strcmp("prefix", cmd -> data.str))
+          { config -> searchtype = SEARCH_PREFIX; }
+        else if (!strcmp("substring", cmd -> data.str))
+          { config -> searchtype = SEARCH_SUBSTRING; }
         else
           { return _("Illegal value for resource SearchType."); }
       }
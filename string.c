@@ -29,6 +29,147 @@
 #include "string.h"
 
 
+/* #############################################################################
+ *
+ * Description    find a string in a memory area; memchr() finds the
+ *                candidates for the first character, which the C library
+ *                does with vector instructions, and only those are compared
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      const char* haystack  - area to search in
+ *                int hsize             - size of the area
+ *                const char* needle    - string to search for
+ *                int nsize             - size of the string
+ * Return         const char* first match or NULL if there is none
+ */
+const char* strFind(const char* haystack, int hsize, const char* needle,
+    int nsize)
+  {
+    const char*         end;
+    const char*         ptr = haystack;
+
+    if (!nsize)
+      { return haystack; }
+    if (nsize > hsize)
+      { return NULL; }
+
+    /* the last position where the needle still fits */
+    end = haystack + hsize - nsize;
+    while (ptr <= end &&
+        (ptr = memchr(ptr, needle[0], end - ptr + 1)))
+      {
+        if (!memcmp(ptr + 1, needle + 1, nsize - 1))
+          { return ptr; }
+        ptr++;
+      }
+
+    return NULL;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    fold the case of an UTF-8 string; ASCII, Latin-1, Latin
+ *                Extended-A, Greek and Cyrillic letters are folded to lower
+ *                case and all other characters are kept; every character
+ *                keeps the length of its encoding, so the folded string has
+ *                the same size as the original one
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      char* dest        - buffer for the folded string, at least
+ *                                    as large as the source
+ *                const char* src   - the UTF-8 string to fold
+ * Return         int 1 if the folded string differs from the source,
+ *                otherwise 0
+ */
+int strFold(char* dest, const char* src)
+  {
+    const unsigned char* ptr = (const unsigned char*)src;
+    unsigned int        code,
+                        lower;
+    int                 changed = 0;
+
+    while (*ptr)
+      {
+        if (*ptr < 0x80)
+          {   /* ASCII */
+            *dest = (*ptr >= 'A' && *ptr <= 'Z') ? *ptr + 32 : *ptr;
+            changed |= (*dest++ != (char)*ptr++);
+            continue;
+          }
+
+        if ((ptr[0] & 0xE0) != 0xC0 ||
+            (ptr[1] & 0xC0) != 0x80)
+          {   /* all longer sequences are kept */
+            *dest++ = *ptr++;
+            continue;
+          }
+
+        code = lower = ((ptr[0] & 0x1F) << 6) | (ptr[1] & 0x3F);
+        if ((code >= 0xC0 && code <= 0xDE && code != 0xD7) ||
+            (code >= 0x391 && code <= 0x3AB && code != 0x3A2) ||
+            (code >= 0x410 && code <= 0x42F))
+          { lower = code + 0x20; }
+        else if ((code >= 0x100 && code <= 0x12F) ||
+            (code >= 0x132 && code <= 0x137) ||
+            (code >= 0x14A && code <= 0x177) ||
+            (code >= 0x460 && code <= 0x481) ||
+            (code >= 0x48A && code <= 0x4BF))
+          { lower = code | 1; }
+        else if ((code >= 0x139 && code <= 0x148) ||
+            (code >= 0x179 && code <= 0x17E))
+          { lower = (code & 1) ? code + 1 : code; }
+        else if (code >= 0x400 && code <= 0x40F)
+          { lower = code + 0x50; }
+        else if (code == 0xB5)
+          { lower = 0x3BC; }
+        else if (code == 0x178)
+          { lower = 0xFF; }
+        else if (code == 0x386)
+          { lower = 0x3AC; }
+        else if (code >= 0x388 && code <= 0x38A)
+          { lower = code + 0x25; }
+        else if (code == 0x38C)
+          { lower = 0x3CC; }
+        else if (code == 0x38E || code == 0x38F)
+          { lower = code + 0x3F; }
+        else if (code == 0x3C2)
+          { lower = 0x3C3; }
+
+        *dest++ = 0xC0 | (lower >> 6);
+        *dest++ = 0x80 | (lower & 0x3F);
+        changed |= (lower != code);
+        ptr += 2;
+      }
+    *dest = 0;
+
+    return changed;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    hash function for strings (FNV-1a)
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      const char* string  - string to hash
+ * Return         unsigned int hash value
+ */
+unsigned int strHash(const char* string)
+  {
+    const unsigned char*  ptr = (const unsigned char*)string;
+    unsigned int        hash = 2166136261U;
+
+    while (*ptr)
+      {
+        hash ^= *ptr++;
+        hash *= 16777619U;
+      }
+
+    return hash;
+  }
+
+
 /* #############################################################################
  *
  * Description    create a new string from the two given ones
@@ -26,6 +26,10 @@
 /* #############################################################################
  * prototypes
  */
+const char* strFind(const char* haystack, int hsize, const char* needle,
+    int nsize);
+int strFold(char* dest, const char* src);
+unsigned int strHash(const char* string);
 char* strNewcat(char* str1, char* str2);
 char* strStrncat(char* dest, const char* src, size_t n);
 char* strStrncpy(char* dest, const char* src, size_t n);
@@ -33,6 +33,7 @@ use Time::localtime;
 @main::alphabet = ();
 
 $main::config{'alphabet'}  = 'alphabet-ascii.txt';
+$main::config{'deep'}      = '0';
 $main::config{'depth-min'} = '1';
 $main::config{'depth-max'} = '4';
 $main::config{'nodes-min'} = '3';
@@ -62,6 +63,7 @@ sub main
 
     if (!GetOptions(
           'alphabet=s'  => \$main::config{'alphabet'},
+          'deep=i'      => \$main::config{'deep'},
           'depth-min=i' => \$main::config{'depth-min'},
           'depth-max=i' => \$main::config{'depth-max'},
           'nodes-min=i' => \$main::config{'nodes-min'},
@@ -80,8 +82,10 @@ syntax: $0 --alphabet=FILE --depth-min=NR --depth-max=NR
                      --nodes-min=NR --nodes-max=NR
                      --text-min=NR --text-max=NR
                      --users-min=NR --users-max=NR
+                     --deep=NR
 
     --alphabet      specify the alphabet file
+    --deep          add a chain of nodes with the given depth
     --depth-min     minimum node depth
     --depth-max     maximum node depth
     --nodes-min     minimum sub-nodes per node
@@ -102,6 +106,8 @@ EOF
 
     xmlHeader($users);
     xmlNode($users, 1, $lmax);
+    if ($main::config{'deep'} > 0)
+      { xmlDeepNode($users, $main::config{'deep'}); }
     xmlFooter();
   }
 
@@ -198,6 +204,32 @@ sub readAlphabet
   }
 
 
+# ##############################################################################
+#
+# Description     print a chain of nested nodes; the nodes are labeled
+#                 'deep1', 'deep2' and so on and are neither indented nor
+#                 created recursively, so the chain can be very deep
+# Author          Harry Brueckner
+# Date            2005-06-01
+# Arguments       $users  - maximum number of possible users
+#                 $depth  - depth of the chain
+# Return          void
+#
+sub xmlDeepNode
+  {
+    my ($users, $depth) = @_;
+    my ($tstamp) = getTimestamp();
+
+    for (my $n = 1; $n <= $depth; $n++)
+      {
+        print sprintf('<node label="deep%d" created-by="%d" created-on="%s">%s',
+            $n, getRandom(1, $users), $tstamp, "\n");
+      }
+    for (my $n = 1; $n <= $depth; $n++)
+      { print "</node>\n"; }
+  }
+
+
 # ##############################################################################
 #
 # Description     print the xml footer
@@ -25,6 +25,7 @@
  * includes
  */
 #include "cpm.h"
+#include <ctype.h>
 #include <stdarg.h>
 #ifdef HAVE_LIBZ
   #include <zlib.h>
@@ -45,7 +46,17 @@
  * internal functions
  */
 int checkDtd(SHOWERROR_FN showerror_cb);
+gpgme_data_encoding_t xmlDataFileEncoding(int fd);
+int xmlReadStreamParse(void* handle, const char* buffer, int size);
+int xmlReadStreamRoute(void* handle, const char* buffer, int size);
+int xmlReadStreamWrite(void* handle, const char* buffer, int size);
 void xmlRemoveDtd(void);
+int xmlWriteStreamCollect(void* handle, const char* buffer, int size);
+void xmlWriteStreamError(void* handle, int action, const char* name);
+int xmlWriteStreamFile(void* handle, const char* buffer, int size);
+int xmlWriteStreamFinish(void* handle, int error);
+int xmlWriteStreamOpen(void* handle);
+int xmlWriteStreamOutput(void* context, const char* buffer, int size);
 void xmlVersionNodeUpdate(long oldversion, xmlNode* rootnode);
 void xmlVersionUpdate(int silent);
 void xmlValidateError(void* context, const char* msg, ...);
@@ -55,7 +66,46 @@ void xmlValidateWarning(void* context, const char* msg, ...);
 /* #############################################################################
  * global variables
  */
+#define BUFFERSIZE      10240
+#define XML_DEFAULTDEPTH  256     /* nesting limit of libxml by default */
+#define XML_MAXAMPLIFICATION 5    /* entity amplification libxml allows */
+#define STREAM_ERROR_ZLIB 1
+#define STREAM_ERROR_FILE 2
+#define STREAM_OPEN       0
+#define STREAM_WRITE      1
+#define STREAM_RENAME     2
+#define WALKSTACK_MINSIZE 64
+
+typedef struct
+  {
+    xmlParserCtxtPtr    parser;
+    ZLIBSTREAM*         inflater;
+    char*               errormsg;
+    char                magic[CODEC_MAGICSIZE];
+    int                 magicsize;
+    int                 codec;
+    int                 error;
+  } XMLREADSTREAM;
+
+typedef struct
+  {
+    SHOWERROR_FN        showerror_cb;
+    ZLIBSTREAM*         deflater;
+    char*               filename;
+    char*               target;     /* database file with symlinks resolved */
+    char*               tempname;   /* written first, renamed at the end */
+    char*               errormsg;
+    char*               buffer;
+    int                 capacity;
+    int                 size;
+    int                 fd;
+    int                 lockfd;     /* keeps the database file locked */
+    int                 error;
+  } XMLWRITESTREAM;
+
 xmlDocPtr               xmldoc;
+xmlNode**               walkstack = NULL;
+int                     walkstacksize = 0;
 SHOWERROR_FN            validateShowError = NULL;
 const static char*      dtd_1 =
     "<!ENTITY % creation \"\n"
@@ -191,6 +241,14 @@ void freeXML(void)
     if (xmldoc)
       { xmlFreeDoc(xmldoc); }
 
+    if (walkstack)
+      {
+        memFree(__FILE__, __LINE__, walkstack,
+            walkstacksize * sizeof(xmlNode*));
+        walkstack = NULL;
+        walkstacksize = 0;
+      }
+
     /* cleanup function for the XML library. */
     xmlCleanupParser();
 
@@ -221,6 +279,44 @@ void initXML(void)
   }
 
 
+/* #############################################################################
+ *
+ * Description    detect if the encrypted data file is ASCII armored or binary
+ *                OpenPGP data; the file offset is not changed
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      int fd  - file descriptor of the data file
+ * Return         the encoding hint for gpgme
+ */
+gpgme_data_encoding_t xmlDataFileEncoding(int fd)
+  {
+    ssize_t             size;
+    int                 i = 0;
+    char                buffer[64];
+
+    TRACE(99, "xmlDataFileEncoding()", NULL);
+
+    size = pread(fd, buffer, sizeof(buffer), 0);
+    if (size <= 0)
+      { return GPGME_DATA_ENCODING_NONE; }
+
+    while (i < size &&
+        isspace((unsigned char)buffer[i]))
+      { i++; }
+
+    if (size - i >= 15 &&
+        !strncmp(buffer + i, "-----BEGIN PGP ", 15))
+      { return GPGME_DATA_ENCODING_ARMOR; }
+    else if (i == 0 &&
+        buffer[0] & 0x80)
+      {   /* every OpenPGP packet header has the highest bit set */
+        return GPGME_DATA_ENCODING_BINARY;
+      }
+    else
+      { return GPGME_DATA_ENCODING_NONE; }
+  }
+
+
 /* #############################################################################
  *
  * Description    read, decrypt and parse the given filename
@@ -235,16 +331,21 @@ void initXML(void)
 int xmlDataFileRead(char* filename, char** errormsg,
     PASSPHRASE_FN passphrase_cb, SHOWERROR_FN showerror_cb)
   {
+    MEMARENA*           arena;
+    XMLREADSTREAM       stream;
     xmlNode*            node;
     struct stat         filestat;
-    off_t               size;
+    ssize_t             size;
+    gpgme_data_encoding_t encoding = GPGME_DATA_ENCODING_NONE;
     int                 error = 0,
                         fd,
-                        gpgsize = 0,
-                        validate;
+                        options,
+                        retry,
+                        validate,
+                        wellformed;
     char*               buffer = NULL;
-    char*               gpgbuffer = NULL;
     char*               tmpbuffer = NULL;
+    char*               zerrormsg;
 
     TRACE(99, "xmlDataFileRead()", NULL);
 
@@ -286,36 +387,138 @@ int xmlDataFileRead(char* filename, char** errormsg,
       }
     else if (!fstat(fd, &filestat) &&
         filestat.st_size)
-      {   /* we found a file and have to read it */
-        size = filestat.st_size;
-        buffer = memAlloc(__FILE__, __LINE__, size);
-        /* Flawfinder: ignore */
-        if (read(fd, buffer, size) != size)
+      {   /* we found a file and have to read it; the data runs through
+           * decryption, decompression and the xml parser in chunks, so
+           * neither the whole file nor the whole plaintext is ever copied
+           * into one buffer.
+           */
+        /* all scratch memory of the load comes from one arena */
+        arena = memArenaCreate(0);
+        buffer = memArenaAlloc(arena, BUFFERSIZE);
+
+        if (config -> encryptdata)
+          { encoding = xmlDataFileEncoding(fd); }
+        else
           {
-            memFree(__FILE__, __LINE__, buffer, size);
-            return 1;
+            /* if we run in unencrypted mode, we must add all default keys */
+            keyDefaults();
+
+            showerror_cb(_("warning"), _("the database file is read in unecrypted mode."));
           }
-        close(fd);
 
-        if (config -> encryptdata)
+        options = XML_PARSE_PEDANTIC | XML_PARSE_NONET | XML_PARSE_NOCDATA;
+        do
           {
-            error = gpgDecrypt(buffer, size, &gpgbuffer, &gpgsize,
-                passphrase_cb, showerror_cb);
-            if (error)
-              { *errormsg = _("could not decrypt database file."); }
+            stream.parser = xmlCreatePushParserCtxt(NULL, NULL, NULL, 0,
+                filename);
+            if (!stream.parser)
+              {
+                *errormsg = _("could not create the XML parser.");
+                close(fd);
+                memArenaFree(arena);
+                return 1;
+              }
 
-            /* since we decrypted the file, we swap buffers */
-            memFree(__FILE__, __LINE__, buffer, size);
-            buffer = gpgbuffer;
-            size = gpgsize;
+            if (config -> encoding)
+              {
+                xmlCtxtResetPush(stream.parser, NULL, 0, filename,
+                    config -> encoding);
+              }
+            xmlCtxtUseOptions(stream.parser, options);
+#if LIBXML_VERSION >= 21100
+            /* XML_PARSE_HUGE is only meant to lift the nesting limit, the
+             * entities must not expand more than by default
+             */
+            if (options & XML_PARSE_HUGE)
+              {
+                xmlCtxtSetMaxAmplification(stream.parser,
+                    XML_MAXAMPLIFICATION);
+              }
+#endif
 
-#ifdef TEST_OPTION
-            if (config -> testrun &&
-                !strcmp("decrypt", config -> testrun) &&
-                buffer)
-              { printf("%s", buffer); }
+            stream.inflater = NULL;
+            stream.errormsg = NULL;
+            stream.magicsize = 0;
+            stream.codec = CODEC_UNKNOWN;
+            stream.error = 0;
+
+            if (config -> encryptdata)
+              {
+                error = gpgDecrypt(fd, encoding, xmlReadStreamWrite, &stream,
+                    passphrase_cb, showerror_cb);
+                if (error)
+                  { *errormsg = _("could not decrypt database file."); }
+              }
+            else
+              {
+                /* Flawfinder: ignore */
+                while ((size = read(fd, buffer, BUFFERSIZE)) > 0)
+                  { xmlReadStreamWrite(&stream, buffer, size); }
+
+                if (size == -1)
+                  {
+                    *errormsg = strerror(errno);
+                    error = 1;
+                  }
+              }
+
+            /* a stream shorter than the magic of a codec is never
+             * compressed
+             */
+            if (stream.codec == CODEC_UNKNOWN &&
+                stream.magicsize)
+              {
+                stream.codec = CODEC_NONE;
+                xmlReadStreamRoute(&stream, stream.magic, stream.magicsize);
+              }
+
+            if (stream.inflater &&
+                zlibInflateEnd(stream.inflater, &zerrormsg) &&
+                !stream.error)
+              {
+                stream.errormsg = zerrormsg;
+                stream.error = 1;
+              }
+
+            /* the parser only sees the data as it is decrypted; if the
+             * decryption or the signature verification failed in the end,
+             * the already parsed document is discarded.
+             */
+            if (!error &&
+                !stream.error)
+              { xmlParseChunk(stream.parser, NULL, 0, 1); }
+            xmldoc = stream.parser -> myDoc;
+            if (error ||
+                stream.error ||
+                !stream.parser -> wellFormed)
+              {
+                if (xmldoc)
+                  { xmlFreeDoc(xmldoc); }
+                xmldoc = NULL;
+              }
+            wellformed = stream.parser -> wellFormed;
+            retry = 0;
+#if LIBXML_VERSION >= 20700
+            if (!error &&
+                !stream.error &&
+                !wellformed &&
+                stream.parser -> nameNr > XML_DEFAULTDEPTH &&
+                !(options & XML_PARSE_HUGE))
+              {   /* generated hierarchies can be much deeper than the
+                   * nesting limit of libxml, only such a document is read
+                   * once more without the limit
+                   */
+                options |= XML_PARSE_HUGE;
+                retry = (lseek(fd, 0, SEEK_SET) == 0);
+              }
 #endif
+            xmlFreeParserCtxt(stream.parser);
+          }
+        while (retry);
+        close(fd);
 
+        if (config -> encryptdata)
+          {
             /* TODO: add the same keys as used in the encrypted file;
              *       For now we just always add the default keys
              */
@@ -329,72 +532,47 @@ int xmlDataFileRead(char* filename, char** errormsg,
 
             keyDefaults();
           }
-        else
-          {
-            /* if we run in unencrypted mode, we must add all default keys */
-            keyDefaults();
-
-            showerror_cb(_("warning"), _("the database file is read in unecrypted mode."));
-          }
 
         if (!error &&
-            buffer[0] == '\x1f' && buffer[1] == '\x8b')
-          {   /* we have a gzipped buffer and must compress it */
-            error = zlibDecompress(buffer, size, &gpgbuffer, &gpgsize,
-                errormsg);
-            if (error)
-              {
-                tmpbuffer = memAlloc(__FILE__, __LINE__, STDBUFFERLENGTH);
-                snprintf(tmpbuffer, STDBUFFERLENGTH,
-                    _("error (%s) compressing file '%s'."),
-                    *errormsg,
-                    filename);
-                showerror_cb(_("compression error"), tmpbuffer);
-                memFree(__FILE__, __LINE__, tmpbuffer, STDBUFFERLENGTH);
+            stream.error)
+          {   /* we have a compressed buffer and could not decompress it */
+            *errormsg = stream.errormsg;
 
-                memFree(__FILE__, __LINE__, buffer, size);
-                return 1;
-              }
+            tmpbuffer = memArenaAlloc(arena, STDBUFFERLENGTH);
+            snprintf(tmpbuffer, STDBUFFERLENGTH,
+                _("error (%s) compressing file '%s'."),
+                *errormsg,
+                filename);
+            showerror_cb(_("compression error"), tmpbuffer);
 
-            memFree(__FILE__, __LINE__, buffer, size);
-            buffer = gpgbuffer;
-            size = gpgsize;
+            memArenaFree(arena);
+            return 1;
           }
-        else
+
+        if (!error &&
+            stream.codec == CODEC_NONE &&
+            config -> compression > 0)
           {
-            if (!error && config -> compression > 0)
-              {
-                tmpbuffer = memAlloc(__FILE__, __LINE__, STDBUFFERLENGTH);
-                snprintf(tmpbuffer, STDBUFFERLENGTH,
-                    _("database '%s' was not compressed."),
-                    filename);
-                showerror_cb(_("warning"), tmpbuffer);
-                memFree(__FILE__, __LINE__, tmpbuffer, STDBUFFERLENGTH);
-              }
+            tmpbuffer = memArenaAlloc(arena, STDBUFFERLENGTH);
+            snprintf(tmpbuffer, STDBUFFERLENGTH,
+                _("database '%s' was not compressed."),
+                filename);
+            showerror_cb(_("warning"), tmpbuffer);
           }
 
-        if (!error)
+        if (!error &&
+            (!wellformed || !xmldoc))
           {
-            xmldoc = xmlReadMemory(buffer, size, filename, config -> encoding,
-                XML_PARSE_PEDANTIC | XML_PARSE_NONET | XML_PARSE_NOCDATA);
-            if (!xmldoc)
-              {
-                memFree(__FILE__, __LINE__, buffer, size);
-
-                tmpbuffer = memAlloc(__FILE__, __LINE__, STDBUFFERLENGTH);
-                snprintf(tmpbuffer, STDBUFFERLENGTH,
-                    _("failed to parse xml document '%s'."),
-                    filename);
-                showerror_cb(_("file error"), tmpbuffer);
-                memFree(__FILE__, __LINE__, tmpbuffer, STDBUFFERLENGTH);
+            tmpbuffer = memArenaAlloc(arena, STDBUFFERLENGTH);
+            snprintf(tmpbuffer, STDBUFFERLENGTH,
+                _("failed to parse xml document '%s'."),
+                filename);
+            showerror_cb(_("file error"), tmpbuffer);
 
-                return 1;
-              }
+            memArenaFree(arena);
+            return 1;
           }
 
-        if (buffer)
-          { memFree(__FILE__, __LINE__, buffer, size); }
-
         /* we update our document version */
         if (!error)
           { xmlVersionUpdate(0); }
@@ -405,19 +583,25 @@ int xmlDataFileRead(char* filename, char** errormsg,
 
             if (validate != 1)
               {
-                tmpbuffer = memAlloc(__FILE__, __LINE__, STDBUFFERLENGTH);
+                tmpbuffer = memArenaAlloc(arena, STDBUFFERLENGTH);
                 snprintf(tmpbuffer, STDBUFFERLENGTH,
                     _("failed to validate xml document '%s'."),
                     filename);
                 showerror_cb(_("file error"), tmpbuffer);
-                memFree(__FILE__, __LINE__, tmpbuffer, STDBUFFERLENGTH);
 
+                memArenaFree(arena);
                 return 1;
               }
+
+            /* the labels are converted once for all readers */
+            xmlInterfaceShadowLabels();
           }
+
+        memArenaFree(arena);
       }
     else
       {   /* the given file has size 0 */
+        close(fd);
         error = 1;
       }
 
@@ -439,15 +623,14 @@ int xmlDataFileRead(char* filename, char** errormsg,
 int xmlDataFileWrite(char* filename, char** errormsg,
     PASSPHRASE_FN passphrase_cb, SHOWERROR_FN showerror_cb)
   {
+    XMLWRITESTREAM      stream;
+    xmlCharEncodingHandlerPtr encoder = NULL;
+    xmlOutputBufferPtr  output;
     xmlNode*            rootnode;
-    xmlChar*            xmlbuffer = NULL;
-    int                 error = 0,
-                        fd,
-                        gpgsize = 0,
-                        size;
-    char*               buffer = NULL;
-    char*               gpgbuffer = NULL;
+    int                 error = 0;
+    char*               encoding;
     char*               tmpbuffer = NULL;
+    char*               zerrormsg;
 
 
     /* we initialize the error message */
@@ -458,100 +641,111 @@ int xmlDataFileWrite(char* filename, char** errormsg,
     if (rootnode)
       { xmlSetModification(rootnode); }
 
-    /* we create the memory buffer */
-    xmlDocDumpMemoryEnc(xmldoc, &xmlbuffer, &size, config -> encoding);
-    buffer = (char*)xmlbuffer;
-
-    if (buffer && !error && config -> encryptdata)
-      {   /* we have a buffer and must compress it */
-        error = zlibCompress(buffer, size, &gpgbuffer, &gpgsize, errormsg);
-        if (error)
-          {
-            tmpbuffer = memAlloc(__FILE__, __LINE__, STDBUFFERLENGTH);
-            snprintf(tmpbuffer, STDBUFFERLENGTH,
-                _("error (%s) compressing file '%s'."),
-                *errormsg,
-                filename);
-            showerror_cb(_("compression error"), tmpbuffer);
-            memFree(__FILE__, __LINE__, tmpbuffer, STDBUFFERLENGTH);
-
-            memFree(__FILE__, __LINE__, buffer, size);
-            return 1;
-          }
-
-        xmlFree(buffer);
-        buffer = gpgbuffer;
-        size = gpgsize;
+    stream.filename = filename;
+    stream.target = NULL;
+    stream.tempname = NULL;
+    stream.showerror_cb = showerror_cb;
+    stream.errormsg = NULL;
+    stream.fd = -1;
+    stream.lockfd = -1;
+    stream.error = 0;
+    stream.deflater = NULL;
+    stream.buffer = NULL;
+    stream.size = 0;
+    stream.capacity = 0;
+
+    if (config -> encryptdata)
+      {   /* the serialized document is compressed on the fly and only the
+           * compressed data is kept for the encryption
+           */
+        stream.deflater = zlibDeflateStart(xmlWriteStreamCollect, &stream,
+            &stream.errormsg);
+        if (!stream.deflater)
+          { stream.error = STREAM_ERROR_ZLIB; }
       }
-    else if (buffer && !error && !config -> encryptdata)
-      {   /* we don't have to encrypt data, so nothing is compressed */
-        gpgbuffer = memAlloc(__FILE__, __LINE__, size);
-        /* Flawfinder: ignore */
-        memcpy(gpgbuffer, buffer, size);
-
-        xmlFree(buffer);
-        buffer = gpgbuffer;
+    else
+      {   /* without encryption the document goes straight to the file */
+        showerror_cb(_("warning"),
+            _("the database file is written in unecrypted mode."));
       }
 
-    if (buffer && !error &&
-        config -> encryptdata)
-      {
-        error = gpgEncrypt(buffer, size, &gpgbuffer, &gpgsize, passphrase_cb,
-            showerror_cb);
-        if (error)
-          { *errormsg = _("could not encrypt database file."); }
+    /* we serialize the document just like xmlDocDumpMemoryEnc() does, but
+     * through our own output callback instead of one big memory buffer
+     */
+    encoding = config -> encoding ? config -> encoding :
+        (char*)xmldoc -> encoding;
+    if (encoding)
+      { encoder = xmlFindCharEncodingHandler(encoding); }
 
-        memFree(__FILE__, __LINE__, buffer, size);
-        buffer = gpgbuffer;
-        size = gpgsize;
+    if (!stream.error &&
+        (encoder || !encoding))
+      {
+        output = xmlOutputBufferCreateIO(xmlWriteStreamOutput, NULL, &stream,
+            encoder);
+        if (!output ||
+            xmlSaveFileTo(output, xmldoc, encoding) == -1)
+          { error = 1; }
       }
-    else
+    else if (!stream.error)
+      { error = 1; }
+
+    if (stream.deflater &&
+        zlibDeflateEnd(stream.deflater, &zerrormsg) &&
+        !stream.error)
       {
-        showerror_cb(_("warning"),
-            _("the database file is written in unecrypted mode."));
+        stream.errormsg = zerrormsg;
+        stream.error = STREAM_ERROR_ZLIB;
       }
 
-    if (buffer && !error)
-      {   /* if we have a buffer we write the file */
-        createBackupfile(filename, showerror_cb);
+    if (error &&
+        !stream.error)
+      { *errormsg = _("could not serialize the database."); }
 
-        fd = fileLockOpen(filename, O_WRONLY | O_CREAT | O_TRUNC,
-            S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP, &tmpbuffer);
-        if (fd == -1)
-          {   /* error opening the file */
-            showerror_cb(_("file error"), tmpbuffer);
-            memFree(__FILE__, __LINE__, tmpbuffer, STDBUFFERLENGTH);
+    if (stream.error == STREAM_ERROR_ZLIB)
+      {
+        *errormsg = stream.errormsg;
+
+        tmpbuffer = memAlloc(__FILE__, __LINE__, STDBUFFERLENGTH);
+        snprintf(tmpbuffer, STDBUFFERLENGTH,
+            _("error (%s) compressing file '%s'."),
+            *errormsg,
+            filename);
+        showerror_cb(_("compression error"), tmpbuffer);
+        memFree(__FILE__, __LINE__, tmpbuffer, STDBUFFERLENGTH);
 
-            *errormsg = strerror(errno);
+        error = 1;
+      }
 
-            memFree(__FILE__, __LINE__, buffer, size);
-            return 1;
-          }
+    if (!error &&
+        !stream.error &&
+        config -> encryptdata)
+      {   /* the data goes to a temporary file which only replaces the
+           * database file once everything was written, so a failing
+           * encryption leaves the database untouched
+           */
+        error = gpgEncrypt(stream.buffer, stream.size, xmlWriteStreamFile,
+            &stream, passphrase_cb, showerror_cb);
+        if (error)
+          { *errormsg = _("could not encrypt database file."); }
+      }
 
-        if (write(fd, buffer, size) != size)
-          {   /* error writing the file */
-            tmpbuffer = memAlloc(__FILE__, __LINE__, STDBUFFERLENGTH);
-            snprintf(tmpbuffer, STDBUFFERLENGTH,
-                _("error %d (%s) writing file '%s'."),
-                errno,
-                strerror(errno),
-                filename);
-            showerror_cb(_("file error"), tmpbuffer);
-            memFree(__FILE__, __LINE__, tmpbuffer, STDBUFFERLENGTH);
+    if (stream.buffer)
+      { memFree(__FILE__, __LINE__, stream.buffer, stream.capacity); }
 
-            *errormsg = strerror(errno);
+    /* an empty result still must truncate the database file */
+    if (!error &&
+        !stream.error &&
+        stream.fd == -1)
+      { xmlWriteStreamFile(&stream, NULL, 0); }
 
-            memFree(__FILE__, __LINE__, buffer, size);
-            return 1;
-          }
+    error = xmlWriteStreamFinish(&stream, error);
 
-        lockf(fd, F_UNLCK, 0L);
-        close(fd);
+    if (stream.error == STREAM_ERROR_FILE)
+      {
+        *errormsg = stream.errormsg;
+        error = 1;
       }
 
-    if (buffer && size)
-      { memFree(__FILE__, __LINE__, buffer, size); }
-
     return error;
   }
 
@@ -591,6 +785,123 @@ xmlNode* xmlGetDocumentRoot(void)
   }
 
 
+/* #############################################################################
+ *
+ * Description    last stage of the read stream which feeds the data to the
+ *                xml push parser
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void* handle        - XMLREADSTREAM of the current read
+ *                const char* buffer  - xml data
+ *                int size            - size of the data
+ * Return         0 to continue the stream
+ */
+int xmlReadStreamParse(void* handle, const char* buffer, int size)
+  {
+    XMLREADSTREAM*      stream = (XMLREADSTREAM*)handle;
+
+    TRACE(99, "xmlReadStreamParse()", NULL);
+
+    /* the parser itself keeps track of errors and ignores all data after
+     * a fatal one, so we just pass everything on
+     */
+    xmlParseChunk(stream -> parser, buffer, size, 0);
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    pass the data either to the decompression or directly to the
+ *                parser, depending on the detected stream type
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void* handle        - XMLREADSTREAM of the current read
+ *                const char* buffer  - plaintext data
+ *                int size            - size of the data
+ * Return         0 to continue the stream
+ */
+int xmlReadStreamRoute(void* handle, const char* buffer, int size)
+  {
+    XMLREADSTREAM*      stream = (XMLREADSTREAM*)handle;
+
+    TRACE(99, "xmlReadStreamRoute()", NULL);
+
+    if (stream -> codec != CODEC_NONE)
+      {
+        if (!stream -> inflater)
+          {
+            stream -> inflater = zlibInflateStart(stream -> codec,
+                xmlReadStreamParse, stream, &stream -> errormsg);
+            if (!stream -> inflater)
+              {
+                stream -> error = 1;
+                return 0;
+              }
+          }
+
+        if (zlibInflateChunk(stream -> inflater, buffer, size,
+                &stream -> errormsg))
+          { stream -> error = 1; }
+      }
+    else
+      { xmlReadStreamParse(stream, buffer, size); }
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    first stage of the read stream which receives the plaintext
+ *                of the database file and detects the codec of compressed
+ *                data by its magic number
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void* handle        - XMLREADSTREAM of the current read
+ *                const char* buffer  - plaintext data
+ *                int size            - size of the data
+ * Return         0 to continue the stream
+ */
+int xmlReadStreamWrite(void* handle, const char* buffer, int size)
+  {
+    XMLREADSTREAM*      stream = (XMLREADSTREAM*)handle;
+
+    TRACE(99, "xmlReadStreamWrite()", NULL);
+
+#ifdef TEST_OPTION
+    if (config -> encryptdata &&
+        config -> testrun &&
+        !strcmp("decrypt", config -> testrun))
+      { fwrite(buffer, 1, size, stdout); }
+#endif
+
+    /* after an error we still accept all data, so GpgMe can finish the
+     * decryption and verify the signature
+     */
+    if (stream -> error)
+      { return 0; }
+
+    while (stream -> codec == CODEC_UNKNOWN &&
+        size > 0)
+      {   /* we collect the first bytes until they tell the codec */
+        stream -> magic[stream -> magicsize++] = *buffer++;
+        size--;
+
+        stream -> codec = zlibCodecDetect(stream -> magic, stream -> magicsize);
+        if (stream -> codec != CODEC_UNKNOWN)
+          { xmlReadStreamRoute(stream, stream -> magic, stream -> magicsize); }
+      }
+
+    if (size > 0 &&
+        !stream -> error)
+      { xmlReadStreamRoute(stream, buffer, size); }
+
+    return 0;
+  }
+
+
 /* #############################################################################
  *
  * Description    remove all DTDs from the XML document
@@ -701,7 +1012,9 @@ void xmlValidateWarning(void* context, const char* msg, ...)
 
 /* #############################################################################
  *
- * Description    walk the tree and update all nodes
+ * Description    walk the tree and update all nodes; the walk is iterative
+ *                and remembers the next sibling of every level on the walk
+ *                stack, so deep trees don't exhaust the program's stack
  * Author         Harry Brueckner
  * Date           2005-04-04
  * Arguments      long oldversion     - the version to convert from
@@ -711,6 +1024,8 @@ void xmlValidateWarning(void* context, const char* msg, ...)
 void xmlVersionNodeUpdate(long oldversion, xmlNode* rootnode)
   {
     xmlNode*            curnode;
+    int                 depth = 0,
+                        size;
 
     TRACE(99, "xmlVersionNodeUpdate()", NULL);
 
@@ -718,8 +1033,14 @@ void xmlVersionNodeUpdate(long oldversion, xmlNode* rootnode)
       { return; }
 
     curnode = rootnode -> children;
-    while (curnode)
+    while (curnode || depth)
       {
+        if (!curnode)
+          {   /* this level is done, we continue with the parent's sibling */
+            curnode = walkstack[--depth];
+            continue;
+          }
+
         if (curnode -> type == XML_ELEMENT_NODE)
           {
             if (oldversion < 0x000000002)
@@ -730,9 +1051,23 @@ void xmlVersionNodeUpdate(long oldversion, xmlNode* rootnode)
               }
           }
 
-        xmlVersionNodeUpdate(oldversion, curnode);
+        if (curnode -> children)
+          {
+            if (depth >= walkstacksize)
+              {
+                size = (walkstacksize) ?
+                    walkstacksize * 2 : WALKSTACK_MINSIZE;
+                walkstack = memRealloc(__FILE__, __LINE__, walkstack,
+                    walkstacksize * sizeof(xmlNode*),
+                    size * sizeof(xmlNode*));
+                walkstacksize = size;
+              }
 
-        curnode = curnode -> next;
+            walkstack[depth++] = curnode -> next;
+            curnode = curnode -> children;
+          }
+        else
+          { curnode = curnode -> next; }
       }
   }
 
@@ -806,6 +1141,342 @@ void xmlVersionUpdate(int silent)
   }
 
 
+/* #############################################################################
+ *
+ * Description    collect the compressed data of the write stream for the
+ *                encryption
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void* handle        - XMLWRITESTREAM of the current write
+ *                const char* buffer  - compressed data
+ *                int size            - size of the data
+ * Return         0 on success, 1 on error
+ */
+int xmlWriteStreamCollect(void* handle, const char* buffer, int size)
+  {
+    XMLWRITESTREAM*     stream = (XMLWRITESTREAM*)handle;
+    int                 capacity;
+
+    TRACE(99, "xmlWriteStreamCollect()", NULL);
+
+    if (stream -> size + size > stream -> capacity)
+      {   /* we grow the buffer geometrically to keep the copies low */
+        capacity = stream -> capacity ? stream -> capacity : BUFFERSIZE;
+        while (stream -> size + size > capacity)
+          { capacity *= 2; }
+
+        stream -> buffer = memRealloc(__FILE__, __LINE__, stream -> buffer,
+            stream -> capacity, capacity);
+        stream -> capacity = capacity;
+      }
+
+    /* Flawfinder: ignore */
+    memcpy(stream -> buffer + stream -> size, buffer, size);
+    stream -> size += size;
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    show a file error of the write stream and remember it
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void* handle        - XMLWRITESTREAM of the current write
+ *                int action          - STREAM_ action which failed
+ *                const char* name    - name of the file
+ * Return         void
+ */
+void xmlWriteStreamError(void* handle, int action, const char* name)
+  {
+    XMLWRITESTREAM*     stream = (XMLWRITESTREAM*)handle;
+    char*               tmpbuffer;
+    int                 code = errno;
+
+    TRACE(99, "xmlWriteStreamError()", NULL);
+
+    stream -> errormsg = strerror(code);
+    stream -> error = STREAM_ERROR_FILE;
+
+    tmpbuffer = memAlloc(__FILE__, __LINE__, STDBUFFERLENGTH);
+    switch (action)
+      {
+        case STREAM_OPEN:
+            snprintf(tmpbuffer, STDBUFFERLENGTH,
+                _("error %d (%s) opening file '%s'."),
+                code,
+                stream -> errormsg,
+                name);
+            break;
+        case STREAM_RENAME:
+            snprintf(tmpbuffer, STDBUFFERLENGTH,
+                _("error %d (%s) renaming file '%s'."),
+                code,
+                stream -> errormsg,
+                name);
+            break;
+        default:
+            snprintf(tmpbuffer, STDBUFFERLENGTH,
+                _("error %d (%s) writing file '%s'."),
+                code,
+                stream -> errormsg,
+                name);
+            break;
+      }
+    (stream -> showerror_cb)(_("file error"), tmpbuffer);
+    memFree(__FILE__, __LINE__, tmpbuffer, STDBUFFERLENGTH);
+  }
+
+
+/* #############################################################################
+ *
+ * Description    write data of the write stream to the file opened by
+ *                xmlWriteStreamOpen() with the first call
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void* handle        - XMLWRITESTREAM of the current write
+ *                const char* buffer  - data to write
+ *                int size            - size of the data
+ * Return         0 on success, 1 on error
+ */
+int xmlWriteStreamFile(void* handle, const char* buffer, int size)
+  {
+    XMLWRITESTREAM*     stream = (XMLWRITESTREAM*)handle;
+
+    TRACE(99, "xmlWriteStreamFile()", NULL);
+
+    if (stream -> error)
+      { return 1; }
+
+    if (stream -> fd == -1 &&
+        xmlWriteStreamOpen(stream))
+      { return 1; }
+
+    if (size &&
+        write(stream -> fd, buffer, size) != size)
+      {   /* error writing the file */
+        xmlWriteStreamError(stream, STREAM_WRITE, stream -> filename);
+        return 1;
+      }
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    open the file of the write stream; the database file is
+ *                locked for the whole write and the data goes to a temporary
+ *                file next to the real database file, which gets its owner
+ *                and permissions; if that's not possible, because the
+ *                directory isn't writable or the owner can't be kept, the
+ *                database file is written in place
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void* handle        - XMLWRITESTREAM of the current write
+ * Return         0 on success, 1 on error
+ */
+int xmlWriteStreamOpen(void* handle)
+  {
+    XMLWRITESTREAM*     stream = (XMLWRITESTREAM*)handle;
+    struct stat         filestat,
+                        pathstat;
+    char*               tmpbuffer;
+    int                 size;
+
+    TRACE(99, "xmlWriteStreamOpen()", NULL);
+
+    /* a symlinked database stays a symlink, we replace the file it points
+     * to; a missing database is created under its own name
+     */
+    stream -> target = memAlloc(__FILE__, __LINE__, PATH_MAX);
+    if (!realpath(stream -> filename, stream -> target))
+      { strStrncpy(stream -> target, stream -> filename, PATH_MAX); }
+
+    while (1)
+      {
+        stream -> lockfd = fileLockOpen(stream -> target, O_WRONLY | O_CREAT,
+            S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP, &tmpbuffer);
+        if (stream -> lockfd == -1)
+          {
+            xmlWriteStreamError(stream, STREAM_OPEN, stream -> target);
+            if (tmpbuffer)
+              { memFree(__FILE__, __LINE__, tmpbuffer, STDBUFFERLENGTH); }
+            return 1;
+          }
+
+        /* while we waited for the lock, another writer may have replaced
+         * the file; then we must lock the new one
+         */
+        if (fstat(stream -> lockfd, &filestat))
+          {
+            xmlWriteStreamError(stream, STREAM_OPEN, stream -> target);
+            return 1;
+          }
+        if (!stat(stream -> target, &pathstat) &&
+            pathstat.st_dev == filestat.st_dev &&
+            pathstat.st_ino == filestat.st_ino)
+          { break; }
+
+        close(stream -> lockfd);
+        stream -> lockfd = -1;
+      }
+
+    /* the backup is taken while no other writer can change the file */
+    createBackupfile(stream -> filename, stream -> showerror_cb);
+
+    /* the temporary file must be in the same directory, otherwise it
+     * can't be renamed over the database file
+     */
+    size = strlen(stream -> target) + 8;
+    stream -> tempname = memAlloc(__FILE__, __LINE__, size);
+    snprintf(stream -> tempname, size, "%s.XXXXXX", stream -> target);
+    stream -> fd = mkstemp(stream -> tempname);
+
+    if (stream -> fd != -1 &&
+        (fchown(stream -> fd, filestat.st_uid, filestat.st_gid) ||
+        fchmod(stream -> fd,
+            filestat.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO))))
+      {   /* the new file would not be the same as the old one */
+        close(stream -> fd);
+        unlink(stream -> tempname);
+        stream -> fd = -1;
+      }
+
+    if (stream -> fd == -1)
+      {   /* we write the locked file in place */
+        memFreeString(__FILE__, __LINE__, stream -> tempname);
+        stream -> tempname = NULL;
+
+        if (ftruncate(stream -> lockfd, 0))
+          {
+            xmlWriteStreamError(stream, STREAM_WRITE, stream -> target);
+            return 1;
+          }
+        stream -> fd = stream -> lockfd;
+      }
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    finish the file of the write stream; if everything was
+ *                written, the temporary file is synced and renamed over the
+ *                database file, otherwise it is removed; the lock of the
+ *                database file is held until the file was replaced
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void* handle        - XMLWRITESTREAM of the current write
+ *                int error           - 1 if the write already failed
+ * Return         0 on success, 1 on error
+ */
+int xmlWriteStreamFinish(void* handle, int error)
+  {
+    XMLWRITESTREAM*     stream = (XMLWRITESTREAM*)handle;
+    int                 synced;
+
+    TRACE(99, "xmlWriteStreamFinish()", NULL);
+
+    if (stream -> fd != -1)
+      {   /* the data must be on the disk before the file replaces the
+           * database
+           */
+        synced = (!error &&
+            !stream -> error &&
+            !fsync(stream -> fd));
+        if (!error &&
+            !stream -> error &&
+            !synced)
+          {
+            xmlWriteStreamError(stream, STREAM_WRITE,
+                (stream -> tempname) ? stream -> tempname : stream -> target);
+          }
+
+        if (stream -> fd != stream -> lockfd &&
+            close(stream -> fd) &&
+            !error &&
+            !stream -> error)
+          {
+            xmlWriteStreamError(stream, STREAM_WRITE, stream -> tempname);
+          }
+        stream -> fd = -1;
+      }
+
+    if (stream -> tempname &&
+        !error &&
+        !stream -> error &&
+        rename(stream -> tempname, stream -> target))
+      {
+        xmlWriteStreamError(stream, STREAM_RENAME, stream -> tempname);
+      }
+
+    if (stream -> tempname &&
+        (error || stream -> error))
+      {   /* the database file stays as it was */
+        unlink(stream -> tempname);
+      }
+
+    /* closing the file releases its lock */
+    if (stream -> lockfd != -1 &&
+        close(stream -> lockfd) &&
+        !stream -> tempname &&
+        !error &&
+        !stream -> error)
+      {
+        xmlWriteStreamError(stream, STREAM_WRITE, stream -> target);
+      }
+    stream -> lockfd = -1;
+
+    if (stream -> tempname)
+      {
+        memFreeString(__FILE__, __LINE__, stream -> tempname);
+        stream -> tempname = NULL;
+      }
+    if (stream -> target)
+      {
+        memFree(__FILE__, __LINE__, stream -> target, PATH_MAX);
+        stream -> target = NULL;
+      }
+
+    return (error || stream -> error) ? 1 : 0;
+  }
+
+/* #############################################################################
+ *
+ * Description    output callback of the xml serializer which passes the data
+ *                either to the compression or directly to the file
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void* context       - XMLWRITESTREAM of the current write
+ *                const char* buffer  - serialized xml data
+ *                int size            - size of the data
+ * Return         number of bytes written or -1 on error
+ */
+int xmlWriteStreamOutput(void* context, const char* buffer, int size)
+  {
+    XMLWRITESTREAM*     stream = (XMLWRITESTREAM*)context;
+
+    TRACE(99, "xmlWriteStreamOutput()", NULL);
+
+    if (stream -> deflater)
+      {
+        if (zlibDeflateChunk(stream -> deflater, buffer, size,
+                &stream -> errormsg))
+          {
+            stream -> error = STREAM_ERROR_ZLIB;
+            return -1;
+          }
+      }
+    else if (xmlWriteStreamFile(stream, buffer, size))
+      { return -1; }
+
+    return size;
+  }
+
+
 /* #############################################################################
  */
 
@@ -25,19 +25,175 @@
  * includes
  */
 #include "cpm.h"
+#ifdef HAVE_LIBPTHREAD
+  #include <pthread.h>
+#endif
 #ifdef HAVE_LIBZ
   #include <zlib.h>
 #endif
+#ifdef HAVE_LIBZSTD
+  #include <zstd.h>
+#endif
 #include "configuration.h"
 #include "general.h"
 #include "memory.h"
 #include "zlib.h"
+#ifdef TEST_OPTION
+  #include <sys/time.h>
+#endif
+
+
+/* #############################################################################
+ * internal functions
+ */
+typedef struct sZlibBuffer ZLIBBUFFER;
+typedef struct sZlibCodec ZLIBCODEC;
+typedef struct sZlibMember ZLIBMEMBER;
+
+typedef int (*ZLIBSTART_FN) (ZLIBSTREAM* stream, char** errormsg);
+typedef int (*ZLIBCHUNK_FN) (ZLIBSTREAM* stream, const char* buffer,
+    int size, char** errormsg);
+typedef int (*ZLIBEND_FN) (ZLIBSTREAM* stream, char** errormsg);
+
+#ifdef TEST_OPTION
+  void testCompressCodecs(void);
+#endif
+int zlibBufferWrite(void* handle, const char* buffer, int size);
+int zlibDeflateFlush(ZLIBSTREAM* stream, int flush, char** errormsg);
+int zlibGzipDeflateChunk(ZLIBSTREAM* stream, const char* buffer, int size,
+    char** errormsg);
+int zlibGzipDeflateEnd(ZLIBSTREAM* stream, char** errormsg);
+int zlibGzipDeflateStart(ZLIBSTREAM* stream, char** errormsg);
+int zlibGzipInflateChunk(ZLIBSTREAM* stream, const char* buffer, int size,
+    char** errormsg);
+int zlibGzipInflateEnd(ZLIBSTREAM* stream, char** errormsg);
+int zlibGzipInflateStart(ZLIBSTREAM* stream, char** errormsg);
+int zlibInflateData(ZLIBSTREAM* stream, const char* buffer, int size,
+    char** errormsg);
+int zlibInflateMembers(ZLIBSTREAM* stream, char** errormsg);
+void* zlibMemberDeflate(void* data);
+void zlibMemberFree(ZLIBSTREAM* stream);
+void* zlibMemberInflate(void* data);
+void zlibMemberReserve(ZLIBMEMBER* member, int size);
+int zlibMemberRun(ZLIBSTREAM* stream, void* (*worker)(void*),
+    char** errormsg);
+int zlibMemberSize(const Byte* buffer, int length);
+void zlibMemberStart(ZLIBSTREAM* stream, int deflating);
+int zlibStreamBuffer(int deflating, int codec, char* srcbuffer, int srclen,
+    char** dstbuffer, int* dstlen, char** errormsg);
+ZLIBSTREAM* zlibStreamCreate(int codec, int deflating, ZLIBWRITE_FN writer,
+    void* handle, char** errormsg);
+int zlibThreads(void);
+#ifdef HAVE_LIBZSTD
+  int zlibZstdDeflateChunk(ZLIBSTREAM* stream, const char* buffer, int size,
+      char** errormsg);
+  int zlibZstdDeflateEnd(ZLIBSTREAM* stream, char** errormsg);
+  int zlibZstdDeflateFlush(ZLIBSTREAM* stream, ZSTD_inBuffer* input,
+      ZSTD_EndDirective mode, char** errormsg);
+  int zlibZstdDeflateStart(ZLIBSTREAM* stream, char** errormsg);
+  int zlibZstdInflateChunk(ZLIBSTREAM* stream, const char* buffer, int size,
+      char** errormsg);
+  int zlibZstdInflateEnd(ZLIBSTREAM* stream, char** errormsg);
+  int zlibZstdInflateStart(ZLIBSTREAM* stream, char** errormsg);
+#endif
 
 
 /* #############################################################################
  * global variables
  */
 #define BUFFERSIZE      10240
+#define GZIP_EXTRASIZE  12          /* gzip header minus zlib header */
+#define GZIP_MAXRATIO   1032        /* maximum ratio of inflate */
+#define ZLIB_BLOCKSIZE  1048576     /* uncompressed size of a member */
+#define ZLIB_MAXMEMBER  (16 * ZLIB_BLOCKSIZE)
+#define ZLIB_MAXPRESIZE (4 * ZLIB_BLOCKSIZE) /* largest buffer before inflate */
+#define ZLIB_MAXTHREADS 32
+#define ZLIB_SIZEOFFSET 16          /* offset of the member size */
+#define ZSTD_MAXRATIO   32768       /* 128 KB in an RLE block of 4 bytes */
+
+/* in the parallel mode the data is split into blocks of ZLIB_BLOCKSIZE which
+ * are compressed on their own and written as a gzip stream of several
+ * members; gzip reads such a stream like a single one. The extra field of
+ * each member header holds the compressed size of the whole member, so the
+ * reader finds the next member without inflating the current one.
+ */
+struct sZlibMember
+  {
+    Byte*               in;         /* data of the member */
+    Byte*               out;        /* result of the worker */
+    int                 insize,     /* allocated size of in, if it's owned */
+                        inlength,
+                        inoffset,   /* offset in the pending data */
+                        outsize,
+                        outlength,
+                        error;
+    char*               errormsg;
+#ifdef HAVE_LIBPTHREAD
+    pthread_t           thread;
+#endif
+  };
+
+struct sZlibBuffer
+  {
+    char*               data;
+    int                 size,
+                        length;
+  };
+
+/* each codec is found by the magic number at the start of its data; the
+ * table is indexed by the COMPRESSION_ types of the configuration and codecs
+ * which were not compiled in have no functions
+ */
+struct sZlibCodec
+  {
+    char*               name;
+    char*               magic;
+    int                 magicsize;
+    ZLIBSTART_FN        deflatestart;
+    ZLIBCHUNK_FN        deflatechunk;
+    ZLIBEND_FN          deflateend;
+    ZLIBSTART_FN        inflatestart;
+    ZLIBCHUNK_FN        inflatechunk;
+    ZLIBEND_FN          inflateend;
+  };
+
+static ZLIBCODEC        zlibcodec[] =
+  {
+    { "gzip", "\x1f\x8b", 2,
+      zlibGzipDeflateStart, zlibGzipDeflateChunk, zlibGzipDeflateEnd,
+      zlibGzipInflateStart, zlibGzipInflateChunk, zlibGzipInflateEnd },
+#ifdef HAVE_LIBZSTD
+    { "zstd", "\x28\xb5\x2f\xfd", 4,
+      zlibZstdDeflateStart, zlibZstdDeflateChunk, zlibZstdDeflateEnd,
+      zlibZstdInflateStart, zlibZstdInflateChunk, zlibZstdInflateEnd },
+#else
+    { "zstd", "\x28\xb5\x2f\xfd", 4,
+      NULL, NULL, NULL,
+      NULL, NULL, NULL },
+#endif
+  };
+
+#define ZLIB_CODECS     ((int)(sizeof(zlibcodec) / sizeof(ZLIBCODEC)))
+
+struct sZlibStream
+  {
+    ZLIBCODEC*          codec;
+    z_stream            zh;
+#ifdef HAVE_LIBZSTD
+    ZSTD_CCtx*          zcctx;
+    ZSTD_DCtx*          zdctx;
+#endif
+    Byte*               zbuffer;
+    ZLIBWRITE_FN        writer;
+    void*               handle;
+    int                 finished;
+    ZLIBMEMBER*         member;     /* NULL unless in the parallel mode */
+    int                 threads,
+                        members,    /* members waiting for the next batch */
+                        written;    /* members written so far */
+    ZLIBBUFFER          pending;    /* compressed data not yet inflated */
+    int                 pendingoffset;  /* start of the next member */
+  };
 
 
 /* #############################################################################
@@ -52,6 +208,12 @@
 void testCompress(void)
   {
     static char*        testpattern = "this is harry's test";
+    struct timeval      start,
+                        stop;
+    double              c_seconds,
+                        u_seconds;
+    long int            c_calls,
+                        u_calls;
     int                 c_size,
                         p_size,
                         size,
@@ -63,6 +225,12 @@ void testCompress(void)
 
     TRACE(99, "testCompress()", NULL);
 
+    if (!strcmp(config -> testrun, "compress"))
+      {   /* this is a benchmark and not a test */
+        testCompressCodecs();
+        return;
+      }
+
     /* each test tries a different buffer size*/
     if (!strcmp(config -> testrun, "compress1"))
       { size = 1048576; }
@@ -76,6 +244,23 @@ void testCompress(void)
       { size = 128; }
     else if (!strcmp(config -> testrun, "compress6"))
       { size = 32; }
+    else if (!strcmp(config -> testrun, "compress7") ||
+        !strcmp(config -> testrun, "compress8"))
+      {   /* the parallel mode writes several members */
+        size = 5 * ZLIB_BLOCKSIZE + 1;
+        config -> compressionthreads = 4;
+      }
+    else if (!strcmp(config -> testrun, "compress9"))
+      {
+        size = 1048576;
+        config -> compressiontype = COMPRESSION_ZSTD;
+      }
+    else if (!strcmp(config -> testrun, "compress10"))
+      {   /* the workers of the zstd library */
+        size = 5 * ZLIB_BLOCKSIZE + 1;
+        config -> compressiontype = COMPRESSION_ZSTD;
+        config -> compressionthreads = 4;
+      }
     else
       { return; }
 
@@ -91,11 +276,41 @@ void testCompress(void)
         u_size += p_size;
       }
 
+    c_calls = memCalls();
+    gettimeofday(&start, NULL);
     zlibCompress(buffer, size, &c_buffer, &c_size, &errormsg);
-    fprintf(stderr, "buffer size: %d -> %d\n", size, c_size);
+    gettimeofday(&stop, NULL);
+    c_calls = memCalls() - c_calls;
+    c_seconds = (stop.tv_sec - start.tv_sec) +
+        (stop.tv_usec - start.tv_usec) / 1000000.0;
+    if (errormsg)
+      { fprintf(stderr, "compression error: %s\n", errormsg); }
+
+    /* the size of zstd data changes with the version of the library */
+    if (config -> compressiontype == COMPRESSION_GZIP)
+      { fprintf(stderr, "buffer size: %d -> %d\n", size, c_size); }
+    else
+      { fprintf(stderr, "buffer size: %d -> compressed\n", size); }
 
+    if (!strcmp(config -> testrun, "compress8"))
+      {   /* the members are read one after the other */
+        config -> compressionthreads = 1;
+      }
+
+    u_calls = memCalls();
+    gettimeofday(&start, NULL);
     zlibDecompress(c_buffer, c_size, &u_buffer, &u_size, &errormsg);
-    fprintf(stderr, "buffer size: %d -> %d\n", c_size, u_size);
+    gettimeofday(&stop, NULL);
+    u_calls = memCalls() - u_calls;
+    u_seconds = (stop.tv_sec - start.tv_sec) +
+        (stop.tv_usec - start.tv_usec) / 1000000.0;
+    if (errormsg)
+      { fprintf(stderr, "decompression error: %s\n", errormsg); }
+
+    if (config -> compressiontype == COMPRESSION_GZIP)
+      { fprintf(stderr, "buffer size: %d -> %d\n", c_size, u_size); }
+    else
+      { fprintf(stderr, "buffer size: compressed -> %d\n", u_size); }
 
     if (size == u_size)
       { fprintf(stderr, "buffer size ok\n"); }
@@ -107,12 +322,213 @@ void testCompress(void)
     else
       { fprintf(stderr, "buffer error\n"); }
 
+    /* the allocations are part of the result, the speed is not */
+    fprintf(stderr, "allocations: %ld -> %ld\n", c_calls, u_calls);
+    fprintf(stderr, "speed: %.2f MB/s -> %.2f MB/s\n",
+        size / max(c_seconds, 0.000001) / 1048576,
+        size / max(u_seconds, 0.000001) / 1048576);
+
     memFree(__FILE__, __LINE__, c_buffer, c_size);
     memFree(__FILE__, __LINE__, u_buffer, u_size);
     memFree(__FILE__, __LINE__, buffer, size);
   }
 #endif
 
+/* #############################################################################
+ *
+ * Description    benchmark of the compression codecs on a generated document
+ *                which looks like a password database; for each codec and
+ *                level the ratio, the speed and the allocations are shown
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         void
+ */
+#ifdef TEST_OPTION
+void testCompressCodecs(void)
+  {
+    static char*        words[] = { "account", "bank", "comment", "database",
+                            "login", "mail", "password", "server", "shell",
+                            "web" };
+    static int          levels[] = { 1, 6, 9 };
+    struct timeval      start,
+                        stop;
+    unsigned int        seed = 1;
+    double              c_seconds,
+                        u_seconds;
+    long int            c_calls,
+                        u_calls;
+    int                 c_size,
+                        codec,
+                        compression,
+                        compressiontype,
+                        i,
+                        length,
+                        size = 8 * 1048576,
+                        u_size;
+    char*               buffer;
+    char*               c_buffer;
+    char*               errormsg;
+    char*               u_buffer;
+
+    TRACE(99, "testCompressCodecs()", NULL);
+
+    /* the same pseudo random document is generated on every run */
+    buffer = memAlloc(__FILE__, __LINE__, size);
+    length = snprintf(buffer, size,
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<root>\n");
+    while (length < size - 256)
+      {
+        seed = seed * 1103515245 + 12345;
+        length += snprintf(buffer + length, size - length,
+            "  <node label=\"%s %u\">\n"
+            "    <node label=\"%s\">%08x%08x</node>\n"
+            "  </node>\n",
+            words[(seed >> 16) % 10], (seed >> 8) & 0xffff,
+            words[(seed >> 20) % 10], seed, seed * 2654435761u);
+      }
+    length += snprintf(buffer + length, size - length, "</root>\n");
+
+    compression = config -> compression;
+    compressiontype = config -> compressiontype;
+
+    printf("codec level    ratio      compress    decompress  allocations\n");
+    for (codec = 0; codec < ZLIB_CODECS; codec++)
+      {
+        if (!zlibcodec[codec].deflatestart)
+          {
+            printf("%-5s not supported\n", zlibcodec[codec].name);
+            continue;
+          }
+
+        for (i = 0; i < (int)(sizeof(levels) / sizeof(int)); i++)
+          {
+            config -> compressiontype = codec;
+            config -> compression = levels[i];
+
+            c_calls = memCalls();
+            gettimeofday(&start, NULL);
+            if (zlibCompress(buffer, length, &c_buffer, &c_size, &errormsg))
+              {
+                printf("%-5s %5d  error (%s)\n", zlibcodec[codec].name,
+                    levels[i], errormsg);
+                continue;
+              }
+            gettimeofday(&stop, NULL);
+            c_calls = memCalls() - c_calls;
+            c_seconds = (stop.tv_sec - start.tv_sec) +
+                (stop.tv_usec - start.tv_usec) / 1000000.0;
+
+            u_calls = memCalls();
+            gettimeofday(&start, NULL);
+            if (zlibDecompress(c_buffer, c_size, &u_buffer, &u_size,
+                    &errormsg))
+              {
+                printf("%-5s %5d  error (%s)\n", zlibcodec[codec].name,
+                    levels[i], errormsg);
+                memFree(__FILE__, __LINE__, c_buffer, c_size);
+                continue;
+              }
+            gettimeofday(&stop, NULL);
+            u_calls = memCalls() - u_calls;
+            u_seconds = (stop.tv_sec - start.tv_sec) +
+                (stop.tv_usec - start.tv_usec) / 1000000.0;
+
+            printf("%-5s %5d  %6.2f%%  %5.0f MB/s  %5.0f MB/s  %4ld -> %ld"
+                "%s\n",
+                zlibcodec[codec].name, levels[i], 100.0 * c_size / length,
+                length / max(c_seconds, 0.000001) / 1048576,
+                length / max(u_seconds, 0.000001) / 1048576,
+                c_calls, u_calls,
+                (length == u_size && !memcmp(buffer, u_buffer, length)) ?
+                    "" : "  buffer error");
+
+            memFree(__FILE__, __LINE__, c_buffer, c_size);
+            memFree(__FILE__, __LINE__, u_buffer, u_size);
+          }
+      }
+
+    config -> compression = compression;
+    config -> compressiontype = compressiontype;
+
+    memFree(__FILE__, __LINE__, buffer, size);
+  }
+#endif
+
+
+/* #############################################################################
+ *
+ * Description    writer function which collects the data of a stream in a
+ *                buffer growing in powers of two
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void* handle        - the ZLIBBUFFER
+ *                const char* buffer  - data to append
+ *                int size            - length of the data
+ * Return         0
+ */
+int zlibBufferWrite(void* handle, const char* buffer, int size)
+  {
+    ZLIBBUFFER*         data = handle;
+    int                 newsize;
+
+    TRACE(99, "zlibBufferWrite()", NULL);
+
+    if (data -> length + size > data -> size)
+      {
+        newsize = max(data -> size, BUFFERSIZE);
+        while (newsize < data -> length + size)
+          { newsize *= 2; }
+
+        if (data -> data)
+          {
+            data -> data = memRealloc(__FILE__, __LINE__, data -> data,
+                data -> size, newsize);
+          }
+        else
+          { data -> data = memAlloc(__FILE__, __LINE__, newsize); }
+        data -> size = newsize;
+      }
+
+    /* Flawfinder: ignore */
+    memcpy(data -> data + data -> length, buffer, size);
+    data -> length += size;
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    detect the codec of compressed data by its magic number
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      const char* buffer  - start of the data
+ *                int size            - length of the data
+ * Return         the COMPRESSION_ type, CODEC_NONE if the data is not
+ *                compressed or CODEC_UNKNOWN if more data is needed to tell
+ */
+int zlibCodecDetect(const char* buffer, int size)
+  {
+    int                 codec,
+                        result = CODEC_NONE;
+
+    TRACE(99, "zlibCodecDetect()", NULL);
+
+    for (codec = 0; codec < ZLIB_CODECS; codec++)
+      {
+        if (memcmp(buffer, zlibcodec[codec].magic,
+            min(size, zlibcodec[codec].magicsize)))
+          { continue; }
+
+        if (size >= zlibcodec[codec].magicsize)
+          { return codec; }
+        else
+          { result = CODEC_UNKNOWN; }
+      }
+
+    return result;
+  }
 
 /* #############################################################################
  *
@@ -131,14 +547,20 @@ int zlibCompress(char* srcbuffer, int srclen, char** dstbuffer, int* dstlen,
     Byte*               zbuffer;
     z_stream            zh;
     int                 error,
-                        extrasize = srclen;
+                        size;
 
     TRACE(99, "zlibCompress()", NULL);
 
     *errormsg = NULL;
 
-    /* we use this buffer for the compression */
-    zbuffer = memAlloc(__FILE__, __LINE__, srclen + extrasize);
+    if (config -> compressiontype != COMPRESSION_GZIP ||
+        zlibThreads() > 1)
+      {   /* other codecs and the members of the parallel mode are built by
+           * the stream
+           */
+        return zlibStreamBuffer(1, config -> compressiontype, srcbuffer,
+            srclen, dstbuffer, dstlen, errormsg);
+      }
 
     zh.zalloc = (alloc_func)0;
     zh.zfree  = (free_func)0;
@@ -149,44 +571,35 @@ int zlibCompress(char* srcbuffer, int srclen, char** dstbuffer, int* dstlen,
     if (error != Z_OK)
       {
         *errormsg = zh.msg;
-        memFree(__FILE__, __LINE__, zbuffer, srclen + extrasize);
         return 1;
       }
 
+    /* the bound holds all of the compressed data, so a single deflate call
+     * does the job; older zlib versions calculate it for the shorter zlib
+     * header instead of the gzip one
+     */
+    size = deflateBound(&zh, srclen) + GZIP_EXTRASIZE;
+    zbuffer = memAlloc(__FILE__, __LINE__, size);
+
     zh.next_out   = zbuffer;
-    zh.avail_out  = (uInt)srclen + extrasize;
+    zh.avail_out  = (uInt)size;
     zh.next_in    = (Byte*)srcbuffer;
     zh.avail_in   = (uInt)srclen;
 
-    do
-      {
-        if (extrasize > srclen)
-          {   /* we increase the ouput buffer until it matches */
-            zbuffer = memRealloc(__FILE__, __LINE__, zbuffer,
-                srclen + extrasize - BUFFERSIZE, srclen + extrasize);
-          }
-        error = deflate(&zh, Z_FINISH);
-        extrasize += BUFFERSIZE;
-      }
-    while (error == Z_OK);
-
-    /* readjust the extrasize */
-    extrasize -= BUFFERSIZE;
-
+    error = deflate(&zh, Z_FINISH);
     if (error != Z_STREAM_END)
       {   /* Z_STREAM_END means everything is ok */
         *errormsg = zh.msg;
-        memFree(__FILE__, __LINE__, zbuffer, srclen + extrasize);
+        memFree(__FILE__, __LINE__, zbuffer, size);
+        deflateEnd(&zh);
         return 1;
       }
 
-    /* we get the data back to the caller */
+    /* the buffer is only shrunk to the used size, which realloc does in
+     * place without copying the data
+     */
     *dstlen = zh.total_out;
-    *dstbuffer = memAlloc(__FILE__, __LINE__, zh.total_out);
-    /* Flawfinder: ignore */
-    memcpy(*dstbuffer, zbuffer, zh.total_out);
-
-    memFree(__FILE__, __LINE__, zbuffer, srclen + extrasize);
+    *dstbuffer = memRealloc(__FILE__, __LINE__, zbuffer, size, zh.total_out);
 
     error = deflateEnd(&zh);
     if (error != Z_OK)
@@ -213,82 +626,1452 @@ int zlibCompress(char* srcbuffer, int srclen, char** dstbuffer, int* dstlen,
 int zlibDecompress(char* srcbuffer, int srclen, char** dstbuffer, int* dstlen,
     char** errormsg)
   {
-    Byte*               zbuffer = NULL;
-    z_stream            zh;
-    int                 error,
-                        offset = 0;
+    int                 codec;
 
     TRACE(99, "zlibDecompress()", NULL);
 
     *errormsg = NULL;
-    *dstbuffer = NULL;
-
-    zh.zalloc = (alloc_func)0;
-    zh.zfree  = (free_func)0;
-    zh.opaque = (voidpf)0;
-
-    zh.next_in  = (Byte*)srcbuffer;
-    zh.avail_in = (uInt)srclen;
 
-    error = inflateInit2(&zh, 15 + 16);
-    if (error != Z_OK)
+    codec = zlibCodecDetect(srcbuffer, srclen);
+    if (codec < 0)
       {
-        *errormsg = zh.msg;
+        *dstbuffer = NULL;
+        *dstlen = 0;
+        *errormsg = "unknown compression type";
         return 1;
       }
 
-    zbuffer = memAlloc(__FILE__, __LINE__, BUFFERSIZE);
+    /* the stream handles single and parallel written data alike */
+    return zlibStreamBuffer(0, codec, srcbuffer, srclen, dstbuffer, dstlen,
+        errormsg);
+  }
 
-    while (1)
-      {
-        /* reset the zbuffer */
-        zh.next_out = zbuffer;
-        zh.avail_out = (uInt)BUFFERSIZE;
 
-        error = inflate(&zh, Z_NO_FLUSH);
+/* #############################################################################
+ *
+ * Description    compress the next chunk of a stream and hand the compressed
+ *                data to the writer of the stream
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream from zlibDeflateStart
+ *                const char* buffer  - data to compress
+ *                int size            - length of the data
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+int zlibDeflateChunk(ZLIBSTREAM* stream, const char* buffer, int size,
+    char** errormsg)
+  {
+    TRACE(99, "zlibDeflateChunk()", NULL);
 
-        if (zh.total_out)
-          {
-            if (*dstbuffer)
-              {   /* we must resize the buffer */
-                *dstbuffer = memRealloc(__FILE__, __LINE__, *dstbuffer,
-                    offset, zh.total_out);
-              }
-            else
-              {   /* we need a new buffer */
-                *dstbuffer = memAlloc(__FILE__, __LINE__, zh.total_out);
-              }
+    *errormsg = NULL;
 
-            /* Flawfinder: ignore */
-            memcpy(*dstbuffer + offset, zbuffer, zh.total_out - offset);
-            offset = zh.total_out;
-          }
+    return (stream -> codec -> deflatechunk)(stream, buffer, size, errormsg);
+  }
 
-        if (error == Z_STREAM_END)
-          { break; }
+/* #############################################################################
+ *
+ * Description    finish a compression stream, write the remaining data and
+ *                free the stream
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream from zlibDeflateStart
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+int zlibDeflateEnd(ZLIBSTREAM* stream, char** errormsg)
+  {
+    int                 error;
+
+    TRACE(99, "zlibDeflateEnd()", NULL);
+
+    *errormsg = NULL;
+
+    error = (stream -> codec -> deflateend)(stream, errormsg);
+    memFree(__FILE__, __LINE__, stream, sizeof(ZLIBSTREAM));
 
-        if (error != Z_OK)
+    return error;
+  }
+
+/* #############################################################################
+ *
+ * Description    run deflate on the pending input of the stream until it is
+ *                consumed and pass all output to the writer
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream from zlibDeflateStart
+ *                int flush           - Z_NO_FLUSH or Z_FINISH
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+int zlibDeflateFlush(ZLIBSTREAM* stream, int flush, char** errormsg)
+  {
+    int                 error,
+                        length;
+
+    TRACE(99, "zlibDeflateFlush()", NULL);
+
+    *errormsg = NULL;
+
+    do
+      {
+        stream -> zh.next_out = stream -> zbuffer;
+        stream -> zh.avail_out = (uInt)BUFFERSIZE;
+
+        error = deflate(&stream -> zh, flush);
+        if (error == Z_STREAM_ERROR)
+          {
+            *errormsg = stream -> zh.msg;
+            return 1;
+          }
+
+        length = BUFFERSIZE - stream -> zh.avail_out;
+        if (length &&
+            (stream -> writer)(stream -> handle, (char*)stream -> zbuffer,
+                length))
           {
-            *errormsg = zh.msg;
-            memFree(__FILE__, __LINE__, zbuffer, BUFFERSIZE);
+            *errormsg = "write error";
             return 1;
           }
       }
+    while (!stream -> zh.avail_out ||
+        (flush == Z_FINISH && error != Z_STREAM_END));
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    start a compression stream with the configured codec and
+ *                compression level; all data passed with zlibDeflateChunk is
+ *                compressed and given to the writer function
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBWRITE_FN writer - function to receive the data
+ *                void* handle        - handle passed to the writer
+ *                char** errormsg     - error message, if any
+ * Return         the new stream or NULL on error
+ */
+ZLIBSTREAM* zlibDeflateStart(ZLIBWRITE_FN writer, void* handle,
+    char** errormsg)
+  {
+    TRACE(99, "zlibDeflateStart()", NULL);
+
+    return zlibStreamCreate(config -> compressiontype, 1, writer, handle,
+        errormsg);
+  }
+
+/* #############################################################################
+ *
+ * Description    compress the next chunk of a gzip stream and hand the
+ *                compressed data to the writer of the stream
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream from zlibDeflateStart
+ *                const char* buffer  - data to compress
+ *                int size            - length of the data
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+int zlibGzipDeflateChunk(ZLIBSTREAM* stream, const char* buffer, int size,
+    char** errormsg)
+  {
+    ZLIBMEMBER*         member;
+    int                 length;
+
+    TRACE(99, "zlibGzipDeflateChunk()", NULL);
+
+    /* in the parallel mode the data is collected until all threads can
+     * compress one member each
+     */
+    while (stream -> member &&
+        size)
+      {
+        member = &stream -> member[stream -> members];
+        length = min(size, ZLIB_BLOCKSIZE - member -> inlength);
+
+        /* Flawfinder: ignore */
+        memcpy(member -> in + member -> inlength, buffer, length);
+        member -> inlength += length;
+        buffer += length;
+        size -= length;
+
+        if (member -> inlength == ZLIB_BLOCKSIZE &&
+            ++stream -> members == stream -> threads &&
+            zlibMemberRun(stream, zlibMemberDeflate, errormsg))
+          { return 1; }
+      }
+    if (stream -> member)
+      { return 0; }
+
+    stream -> zh.next_in  = (Byte*)buffer;
+    stream -> zh.avail_in = (uInt)size;
+
+    return zlibDeflateFlush(stream, Z_NO_FLUSH, errormsg);
+  }
+
+
+/* #############################################################################
+ *
+ * Description    finish a gzip compression stream and write the remaining
+ *                data
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream from zlibDeflateStart
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+int zlibGzipDeflateEnd(ZLIBSTREAM* stream, char** errormsg)
+  {
+    int                 error;
+
+    TRACE(99, "zlibGzipDeflateEnd()", NULL);
+
+    if (stream -> member)
+      {   /* an empty stream still gets one empty member */
+        if (stream -> member[stream -> members].inlength ||
+            (!stream -> written && !stream -> members))
+          { stream -> members++; }
+
+        error = 0;
+        if (stream -> members)
+          { error = zlibMemberRun(stream, zlibMemberDeflate, errormsg); }
+
+        zlibMemberFree(stream);
+
+        return error;
+      }
+
+    stream -> zh.next_in  = Z_NULL;
+    stream -> zh.avail_in = 0;
+
+    error = zlibDeflateFlush(stream, Z_FINISH, errormsg);
+
+    if (deflateEnd(&stream -> zh) != Z_OK &&
+        !error)
+      {
+        *errormsg = stream -> zh.msg;
+        error = 1;
+      }
+
+    memFree(__FILE__, __LINE__, stream -> zbuffer, BUFFERSIZE);
+
+    return error;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    start the gzip compression of a stream with the configured
+ *                compression level; the data is given to the writer function
+ *                in BUFFERSIZE steps, or member by member if several threads
+ *                compress the data
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - the new stream
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+int zlibGzipDeflateStart(ZLIBSTREAM* stream, char** errormsg)
+  {
+    int                 error;
+
+    TRACE(99, "zlibGzipDeflateStart()", NULL);
 
-    *dstlen = offset;
+    zlibMemberStart(stream, 1);
+    if (stream -> member)
+      {   /* the members are compressed by their own streams */
+        stream -> zbuffer = NULL;
+        return 0;
+      }
 
-    memFree(__FILE__, __LINE__, zbuffer, BUFFERSIZE);
+    stream -> zh.zalloc = (alloc_func)0;
+    stream -> zh.zfree  = (free_func)0;
+    stream -> zh.opaque = (voidpf)0;
 
-    error = inflateEnd(&zh);
+    error = deflateInit2(&stream -> zh, config -> compression, Z_DEFLATED,
+        15 + 16, MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
     if (error != Z_OK)
       {
-        *errormsg = zh.msg;
+        *errormsg = stream -> zh.msg;
         return 1;
       }
 
+    stream -> zbuffer = memAlloc(__FILE__, __LINE__, BUFFERSIZE);
+
     return 0;
   }
 
+/* #############################################################################
+ *
+ * Description    inflate the next chunk of a gzip stream and hand the
+ *                decompressed data to the writer of the stream
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream from zlibInflateStart
+ *                const char* buffer  - compressed data
+ *                int size            - length of the compressed data
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+int zlibGzipInflateChunk(ZLIBSTREAM* stream, const char* buffer, int size,
+    char** errormsg)
+  {
+    TRACE(99, "zlibGzipInflateChunk()", NULL);
+
+    if (!stream -> member)
+      { return zlibInflateData(stream, buffer, size, errormsg); }
+
+    /* the parallel mode collects whole members first */
+    zlibBufferWrite(&stream -> pending, buffer, size);
+
+    return zlibInflateMembers(stream, errormsg);
+  }
+
+
+/* #############################################################################
+ *
+ * Description    finish a gzip decompression stream
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream from zlibInflateStart
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+int zlibGzipInflateEnd(ZLIBSTREAM* stream, char** errormsg)
+  {
+    int                 error;
+
+    TRACE(99, "zlibGzipInflateEnd()", NULL);
+
+    error = 0;
+
+    if (stream -> member)
+      {   /* the last members are inflated; whatever is left is no complete
+           * member and runs through the stream to get the right error
+           */
+        if (stream -> members)
+          { error = zlibMemberRun(stream, zlibMemberInflate, errormsg); }
+        if (stream -> written)
+          { stream -> finished = 1; }
+        if (!error &&
+            stream -> pendingoffset < stream -> pending.length)
+          {
+            error = zlibInflateData(stream,
+                stream -> pending.data + stream -> pendingoffset,
+                stream -> pending.length - stream -> pendingoffset, errormsg);
+          }
+
+        zlibMemberFree(stream);
+      }
+
+    if (inflateEnd(&stream -> zh) != Z_OK &&
+        !error)
+      {
+        *errormsg = stream -> zh.msg;
+        error = 1;
+      }
+    else if (!error &&
+        !stream -> finished)
+      {   /* the compressed data was truncated */
+        *errormsg = "unexpected end of data";
+        error = 1;
+      }
+
+    memFree(__FILE__, __LINE__, stream -> zbuffer, BUFFERSIZE);
+
+    return error;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    start the gzip decompression of a stream; the data is
+ *                decompressed in BUFFERSIZE steps and given to the writer
+ *                function, so the decompressed data is never held in one
+ *                piece
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - the new stream
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+int zlibGzipInflateStart(ZLIBSTREAM* stream, char** errormsg)
+  {
+    int                 error;
+
+    TRACE(99, "zlibGzipInflateStart()", NULL);
+
+    stream -> zh.zalloc = (alloc_func)0;
+    stream -> zh.zfree  = (free_func)0;
+    stream -> zh.opaque = (voidpf)0;
+
+    /* the stream is needed even in the parallel mode for data which was
+     * not written in parallel
+     */
+    stream -> zh.next_in  = Z_NULL;
+    stream -> zh.avail_in = 0;
+
+    error = inflateInit2(&stream -> zh, 15 + 16);
+    if (error != Z_OK)
+      {
+        *errormsg = stream -> zh.msg;
+        return 1;
+      }
+
+    stream -> zbuffer = memAlloc(__FILE__, __LINE__, BUFFERSIZE);
+    stream -> zh.avail_out = (uInt)BUFFERSIZE;
+
+    zlibMemberStart(stream, 0);
+
+    return 0;
+  }
+
+/* #############################################################################
+ *
+ * Description    decompress the next chunk of a stream and hand the
+ *                decompressed data to the writer of the stream
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream from zlibInflateStart
+ *                const char* buffer  - compressed data
+ *                int size            - length of the compressed data
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+int zlibInflateChunk(ZLIBSTREAM* stream, const char* buffer, int size,
+    char** errormsg)
+  {
+    TRACE(99, "zlibInflateChunk()", NULL);
+
+    *errormsg = NULL;
+
+    return (stream -> codec -> inflatechunk)(stream, buffer, size, errormsg);
+  }
+
+/* #############################################################################
+ *
+ * Description    inflate data of a stream one member after the other and hand
+ *                the decompressed data to the writer of the stream
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream from zlibInflateStart
+ *                const char* buffer  - compressed data
+ *                int size            - length of the compressed data
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+int zlibInflateData(ZLIBSTREAM* stream, const char* buffer, int size,
+    char** errormsg)
+  {
+    int                 error,
+                        length;
+
+    TRACE(99, "zlibInflateData()", NULL);
+
+    stream -> zh.next_in  = (Byte*)buffer;
+    stream -> zh.avail_in = (uInt)size;
+
+    /* a member may be followed by another one, which is what the parallel
+     * compression writes; any other data after the end of the gzip stream is
+     * ignored
+     */
+    while (stream -> zh.avail_in ||
+        (!stream -> finished && !stream -> zh.avail_out))
+      {
+        if (stream -> finished)
+          {
+            if (stream -> zh.next_in[0] != 0x1f ||
+                (stream -> zh.avail_in > 1 && stream -> zh.next_in[1] != 0x8b))
+              { break; }
+
+            inflateReset(&stream -> zh);
+            stream -> finished = 0;
+          }
+
+        stream -> zh.next_out = stream -> zbuffer;
+        stream -> zh.avail_out = (uInt)BUFFERSIZE;
+
+        error = inflate(&stream -> zh, Z_NO_FLUSH);
+
+        length = BUFFERSIZE - stream -> zh.avail_out;
+        if (length &&
+            (stream -> writer)(stream -> handle, (char*)stream -> zbuffer,
+                length))
+          {
+            *errormsg = "write error";
+            return 1;
+          }
+
+        if (error == Z_STREAM_END)
+          { stream -> finished = 1; }
+        else if (error == Z_BUF_ERROR)
+          { break; }
+        else if (error != Z_OK)
+          {
+            *errormsg = stream -> zh.msg;
+            return 1;
+          }
+      }
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    finish and free a decompression stream
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream from zlibInflateStart
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+int zlibInflateEnd(ZLIBSTREAM* stream, char** errormsg)
+  {
+    int                 error;
+
+    TRACE(99, "zlibInflateEnd()", NULL);
+
+    *errormsg = NULL;
+
+    error = (stream -> codec -> inflateend)(stream, errormsg);
+    memFree(__FILE__, __LINE__, stream, sizeof(ZLIBSTREAM));
+
+    return error;
+  }
+
+/* #############################################################################
+ *
+ * Description    queue all complete members of the collected data and
+ *                inflate them as soon as there is one for each thread; data
+ *                which was not written in the parallel mode is inflated as
+ *                one stream from then on
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream from zlibInflateStart
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+int zlibInflateMembers(ZLIBSTREAM* stream, char** errormsg)
+  {
+    ZLIBMEMBER*         member;
+    int                 error = 0,
+                        length,
+                        size;
+
+    TRACE(99, "zlibInflateMembers()", NULL);
+
+    while (1)
+      {
+        length = stream -> pending.length - stream -> pendingoffset;
+        size = zlibMemberSize(
+            (Byte*)stream -> pending.data + stream -> pendingoffset, length);
+        if (!size)
+          {   /* the members before still go first */
+            if (stream -> members)
+              { error = zlibMemberRun(stream, zlibMemberInflate, errormsg); }
+            if (stream -> written)
+              { stream -> finished = 1; }
+            if (!error)
+              {
+                error = zlibInflateData(stream,
+                    stream -> pending.data + stream -> pendingoffset, length,
+                    errormsg);
+              }
+
+            zlibMemberFree(stream);
+            return error;
+          }
+        else if (size == -1 ||
+            size > length)
+          {   /* we wait for the rest of the member */
+            return 0;
+          }
+
+        member = &stream -> member[stream -> members++];
+        member -> inoffset = stream -> pendingoffset;
+        member -> inlength = size;
+        stream -> pendingoffset += size;
+
+        if (stream -> members == stream -> threads)
+          {
+            if (zlibMemberRun(stream, zlibMemberInflate, errormsg))
+              { return 1; }
+
+            /* the inflated members are dropped from the collected data */
+            length = stream -> pending.length - stream -> pendingoffset;
+            memmove(stream -> pending.data,
+                stream -> pending.data + stream -> pendingoffset, length);
+            stream -> pending.length = length;
+            stream -> pendingoffset = 0;
+          }
+      }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    start a decompression stream of the given codec; all data
+ *                passed with zlibInflateChunk is decompressed and given to the
+ *                writer function
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      int codec           - codec from zlibCodecDetect
+ *                ZLIBWRITE_FN writer - function to receive the data
+ *                void* handle        - handle passed to the writer
+ *                char** errormsg     - error message, if any
+ * Return         the new stream or NULL on error
+ */
+ZLIBSTREAM* zlibInflateStart(int codec, ZLIBWRITE_FN writer, void* handle,
+    char** errormsg)
+  {
+    TRACE(99, "zlibInflateStart()", NULL);
+
+    return zlibStreamCreate(codec, 0, writer, handle, errormsg);
+  }
+
+/* #############################################################################
+ *
+ * Description    compress a single member of the parallel mode; the member
+ *                size is written to the extra field of the header
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void* data  - the ZLIBMEMBER
+ * Return         void* NULL
+ */
+void* zlibMemberDeflate(void* data)
+  {
+    ZLIBMEMBER*         member = data;
+    gz_header           header;
+    z_stream            zh;
+    Byte                extra[8] = { 'C', 'P', 4, 0, 0, 0, 0, 0 };
+
+    TRACE(99, "zlibMemberDeflate()", NULL);
+
+    member -> error = 1;
+    member -> errormsg = "compression error";
+    member -> outlength = 0;
+
+    zh.zalloc = (alloc_func)0;
+    zh.zfree  = (free_func)0;
+    zh.opaque = (voidpf)0;
+
+    if (deflateInit2(&zh, config -> compression, Z_DEFLATED, 15 + 16,
+        MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK)
+      {
+        if (zh.msg)
+          { member -> errormsg = zh.msg; }
+        return NULL;
+      }
+
+    memset(&header, 0, sizeof(header));
+    header.os = 3;
+    header.extra = extra;
+    header.extra_len = sizeof(extra);
+    deflateSetHeader(&zh, &header);
+
+    zlibMemberReserve(member,
+        deflateBound(&zh, member -> inlength) + GZIP_EXTRASIZE +
+        sizeof(extra) + 2);
+
+    zh.next_in   = member -> in;
+    zh.avail_in  = (uInt)member -> inlength;
+    zh.next_out  = member -> out;
+    zh.avail_out = (uInt)member -> outsize;
+
+    if (deflate(&zh, Z_FINISH) == Z_STREAM_END)
+      {
+        member -> outlength = zh.total_out;
+        member -> out[ZLIB_SIZEOFFSET]     = zh.total_out & 0xff;
+        member -> out[ZLIB_SIZEOFFSET + 1] = (zh.total_out >> 8) & 0xff;
+        member -> out[ZLIB_SIZEOFFSET + 2] = (zh.total_out >> 16) & 0xff;
+        member -> out[ZLIB_SIZEOFFSET + 3] = (zh.total_out >> 24) & 0xff;
+        member -> error = 0;
+      }
+    else if (zh.msg)
+      { member -> errormsg = zh.msg; }
+
+    deflateEnd(&zh);
+
+    return NULL;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    free the members and the collected data of the parallel
+ *                mode; the stream continues in the normal mode
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream with members
+ * Return         void
+ */
+void zlibMemberFree(ZLIBSTREAM* stream)
+  {
+    int                 i;
+
+    TRACE(99, "zlibMemberFree()", NULL);
+
+    for (i = 0; i < stream -> threads; i++)
+      {
+        if (stream -> member[i].insize)
+          {   /* only the members which compress own their data */
+            memFree(__FILE__, __LINE__, stream -> member[i].in,
+                stream -> member[i].insize);
+          }
+        memFree(__FILE__, __LINE__, stream -> member[i].out,
+            stream -> member[i].outsize);
+      }
+    memFree(__FILE__, __LINE__, stream -> member,
+        stream -> threads * sizeof(ZLIBMEMBER));
+    stream -> member = NULL;
+
+    memFree(__FILE__, __LINE__, stream -> pending.data, stream -> pending.size);
+    stream -> pending.data = NULL;
+    stream -> pending.size = stream -> pending.length = 0;
+    stream -> pendingoffset = 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    inflate a single member of the parallel mode into a buffer
+ *                of the size given in the gzip trailer
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void* data  - the ZLIBMEMBER
+ * Return         void* NULL
+ */
+void* zlibMemberInflate(void* data)
+  {
+    ZLIBMEMBER*         member = data;
+    z_stream            zh;
+    Byte*               trailer;
+    unsigned long       size;
+
+    TRACE(99, "zlibMemberInflate()", NULL);
+
+    member -> error = 1;
+    member -> errormsg = "invalid compressed data";
+    member -> outlength = 0;
+
+    trailer = member -> in + member -> inlength - 4;
+    size = trailer[0] | trailer[1] << 8 | trailer[2] << 16 |
+        (unsigned long)trailer[3] << 24;
+    if (size > ZLIB_MAXMEMBER)
+      { return NULL; }
+
+    /* one more byte than needed makes inflate see the end of the member */
+    zlibMemberReserve(member, size + 1);
+
+    zh.zalloc = (alloc_func)0;
+    zh.zfree  = (free_func)0;
+    zh.opaque = (voidpf)0;
+
+    zh.next_in  = member -> in;
+    zh.avail_in = (uInt)member -> inlength;
+
+    if (inflateInit2(&zh, 15 + 16) != Z_OK)
+      {
+        if (zh.msg)
+          { member -> errormsg = zh.msg; }
+        return NULL;
+      }
+
+    zh.next_out  = member -> out;
+    zh.avail_out = (uInt)member -> outsize;
+
+    if (inflate(&zh, Z_FINISH) == Z_STREAM_END &&
+        !zh.avail_in)
+      {
+        member -> outlength = zh.total_out;
+        member -> error = 0;
+      }
+    else if (zh.msg)
+      { member -> errormsg = zh.msg; }
+
+    inflateEnd(&zh);
+
+    return NULL;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    make sure the output buffer of a member has the given size;
+ *                the buffer is kept for the next members
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBMEMBER* member  - member to check
+ *                int size            - minimum size of the buffer
+ * Return         void
+ */
+void zlibMemberReserve(ZLIBMEMBER* member, int size)
+  {
+    if (member -> outsize >= size)
+      { return; }
+
+    memFree(__FILE__, __LINE__, member -> out, member -> outsize);
+    member -> out = memAlloc(__FILE__, __LINE__, size);
+    member -> outsize = size;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    run the worker on all queued members, one thread each, and
+ *                hand the results to the writer in their order
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream    - stream with queued members
+ *                void* (*worker)(void*)  - zlibMemberDeflate or
+ *                                          zlibMemberInflate
+ *                char** errormsg       - error message, if any
+ * Return         1 on error, 0 on success
+ */
+int zlibMemberRun(ZLIBSTREAM* stream, void* (*worker)(void*),
+    char** errormsg)
+  {
+    ZLIBMEMBER*         member = stream -> member;
+    int                 error = 0,
+                        i,
+                        threads = 1;
+
+    TRACE(99, "zlibMemberRun()", NULL);
+
+    /* members which are inflated point into the collected data */
+    for (i = 0; i < stream -> members; i++)
+      {
+        if (!member[i].insize)
+          { member[i].in = (Byte*)stream -> pending.data + member[i].inoffset; }
+      }
+
+#ifdef HAVE_LIBPTHREAD
+    for (threads = 1; threads < stream -> members; threads++)
+      {
+        if (pthread_create(&member[threads].thread, NULL, worker,
+            &member[threads]))
+          {   /* if we can't start a thread, we do the work here */
+            break;
+          }
+      }
+#endif
+    worker(&member[0]);
+    for (i = threads; i < stream -> members; i++)
+      { worker(&member[i]); }
+#ifdef HAVE_LIBPTHREAD
+    for (i = 1; i < threads; i++)
+      { pthread_join(member[i].thread, NULL); }
+#endif
+
+    for (i = 0; i < stream -> members; i++)
+      {
+        if (error)
+          { /* the rest is dropped */ }
+        else if (member[i].error)
+          {
+            *errormsg = member[i].errormsg;
+            error = 1;
+          }
+        else if (member[i].outlength &&
+            (stream -> writer)(stream -> handle, (char*)member[i].out,
+                member[i].outlength))
+          {
+            *errormsg = "write error";
+            error = 1;
+          }
+        member[i].inlength = 0;
+      }
+
+    stream -> written += stream -> members;
+    stream -> members = 0;
+
+    return error;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    get the size of the member at the start of the buffer from
+ *                the extra field the parallel mode writes
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      const Byte* buffer  - start of the member
+ *                int length          - length of the available data
+ * Return         size of the member, 0 if the member was not written in the
+ *                parallel mode and -1 if more data is needed to tell
+ */
+int zlibMemberSize(const Byte* buffer, int length)
+  {
+    unsigned long       size;
+
+    if (length < ZLIB_SIZEOFFSET + 4)
+      { return -1; }
+
+    if (buffer[0] != 0x1f ||
+        buffer[1] != 0x8b ||
+        buffer[2] != Z_DEFLATED ||
+        !(buffer[3] & 0x04) ||
+        buffer[10] != 8 ||
+        buffer[11] != 0 ||
+        buffer[12] != 'C' ||
+        buffer[13] != 'P' ||
+        buffer[14] != 4 ||
+        buffer[15] != 0)
+      { return 0; }
+
+    size = buffer[16] | buffer[17] << 8 | buffer[18] << 16 |
+        (unsigned long)buffer[19] << 24;
+    if (size < ZLIB_SIZEOFFSET + 4 + 8 ||
+        size > ZLIB_MAXMEMBER)
+      { return 0; }
+
+    return (int)size;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    set up the parallel mode of a stream if more than one
+ *                thread is configured
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - new stream
+ *                int deflating       - 1 if the stream compresses
+ * Return         void
+ */
+void zlibMemberStart(ZLIBSTREAM* stream, int deflating)
+  {
+    int                 i;
+
+    TRACE(99, "zlibMemberStart()", NULL);
+
+    stream -> member = NULL;
+    stream -> threads = zlibThreads();
+    stream -> members = 0;
+    stream -> written = 0;
+    stream -> pending.data = NULL;
+    stream -> pending.size = stream -> pending.length = 0;
+    stream -> pendingoffset = 0;
+
+    if (stream -> threads < 2)
+      { return; }
+
+    stream -> member = memAlloc(__FILE__, __LINE__,
+        stream -> threads * sizeof(ZLIBMEMBER));
+    for (i = 0; i < stream -> threads; i++)
+      {
+        if (deflating)
+          {
+            stream -> member[i].in = memAlloc(__FILE__, __LINE__,
+                ZLIB_BLOCKSIZE);
+            stream -> member[i].insize = ZLIB_BLOCKSIZE;
+          }
+        else
+          {
+            stream -> member[i].in = NULL;
+            stream -> member[i].insize = 0;
+          }
+        stream -> member[i].inlength = 0;
+        stream -> member[i].inoffset = 0;
+        stream -> member[i].out = NULL;
+        stream -> member[i].outsize = 0;
+        stream -> member[i].outlength = 0;
+        stream -> member[i].error = 0;
+        stream -> member[i].errormsg = NULL;
+      }
+  }
+
+
+/* #############################################################################
+ *
+ * Description    compress or decompress a whole buffer with a stream
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      int deflating     - 1 to compress, 0 to decompress
+ *                int codec         - COMPRESSION_ type of the data
+ *                char* srcbuffer   - source buffer
+ *                int srclen        - length of the source buffer
+ *                char** dstbuffer  - result buffer
+ *                int* dstlen       - length of the result buffer
+ *                char** errormsg   - error message, if any
+ * Return         1 on error, 0 on success
+ */
+int zlibStreamBuffer(int deflating, int codec, char* srcbuffer, int srclen,
+    char** dstbuffer, int* dstlen, char** errormsg)
+  {
+    ZLIBBUFFER          buffer;
+    ZLIBSTREAM*         stream;
+    Byte*               trailer;
+    unsigned long       size = 0;
+#ifdef HAVE_LIBZSTD
+    unsigned long long  content;
+#endif
+    char*               endmsg;
+    int                 error;
+
+    TRACE(99, "zlibStreamBuffer()", NULL);
+
+    *dstbuffer = NULL;
+    *dstlen = 0;
+
+    if (deflating &&
+        codec == COMPRESSION_GZIP)
+      {   /* every member adds its header and trailer */
+        size = compressBound(srclen) +
+            (srclen / ZLIB_BLOCKSIZE + 1) * (GZIP_EXTRASIZE + 32);
+      }
+#ifdef HAVE_LIBZSTD
+    else if (deflating &&
+        codec == COMPRESSION_ZSTD)
+      { size = ZSTD_compressBound(srclen); }
+    else if (codec == COMPRESSION_ZSTD)
+      {   /* the frame header holds the size of the data if it was known
+           * when the data was compressed
+           */
+        content = ZSTD_getFrameContentSize(srcbuffer, srclen);
+        if (content != ZSTD_CONTENTSIZE_UNKNOWN &&
+            content != ZSTD_CONTENTSIZE_ERROR &&
+            content <= (unsigned long long)srclen * ZSTD_MAXRATIO)
+          { size = (unsigned long)content; }
+      }
+#endif
+    else if (!deflating &&
+        srclen >= 18)
+      {   /* the gzip trailer holds the size of the data; if there are
+           * several members it's only the size of the last one, so the
+           * buffer still grows in powers of two if it's too small
+           */
+        trailer = (Byte*)srcbuffer + srclen - 4;
+        size = trailer[0] | trailer[1] << 8 | trailer[2] << 16 |
+            (unsigned long)trailer[3] << 24;
+        if (size > (unsigned long)srclen * GZIP_MAXRATIO)
+          { size = 0; }
+      }
+
+    /* the sizes above are only hints of the data: the ratio check merely
+     * drops the ones which can't be right, but even a small source may claim
+     * a huge size; so no more than ZLIB_MAXPRESIZE is allocated before the
+     * data arrives and the buffer grows beyond it on demand
+     */
+    if (!deflating &&
+        size > ZLIB_MAXPRESIZE)
+      { size = ZLIB_MAXPRESIZE; }
+
+    buffer.data = NULL;
+    buffer.size = (int)size;
+    buffer.length = 0;
+    if (size)
+      { buffer.data = memAlloc(__FILE__, __LINE__, size); }
+
+    if (deflating)
+      { stream = zlibDeflateStart(zlibBufferWrite, &buffer, errormsg); }
+    else
+      { stream = zlibInflateStart(codec, zlibBufferWrite, &buffer, errormsg); }
+    if (!stream)
+      {
+        memFree(__FILE__, __LINE__, buffer.data, buffer.size);
+        return 1;
+      }
+
+#ifdef HAVE_LIBZSTD
+    if (deflating &&
+        codec == COMPRESSION_ZSTD)
+      {   /* the size goes into the frame header for the decompression */
+        ZSTD_CCtx_setPledgedSrcSize(stream -> zcctx, srclen);
+      }
+#endif
+
+    if (deflating)
+      {
+        error = zlibDeflateChunk(stream, srcbuffer, srclen, errormsg);
+        error |= zlibDeflateEnd(stream, error ? &endmsg : errormsg);
+      }
+    else
+      {
+        error = zlibInflateChunk(stream, srcbuffer, srclen, errormsg);
+        error |= zlibInflateEnd(stream, error ? &endmsg : errormsg);
+      }
+
+    if (error ||
+        !buffer.length)
+      {
+        memFree(__FILE__, __LINE__, buffer.data, buffer.size);
+        return error;
+      }
+
+    /* the caller gets a buffer of the exact size; shrinking it doesn't copy
+     * the data
+     */
+    if (buffer.size != buffer.length)
+      {
+        buffer.data = memRealloc(__FILE__, __LINE__, buffer.data, buffer.size,
+            buffer.length);
+      }
+    *dstbuffer = buffer.data;
+    *dstlen = buffer.length;
+
+    return 0;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    create a compression or decompression stream of the given
+ *                codec
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      int codec           - COMPRESSION_ type of the stream
+ *                int deflating       - 1 to compress, 0 to decompress
+ *                ZLIBWRITE_FN writer - function to receive the data
+ *                void* handle        - handle passed to the writer
+ *                char** errormsg     - error message, if any
+ * Return         the new stream or NULL on error
+ */
+ZLIBSTREAM* zlibStreamCreate(int codec, int deflating, ZLIBWRITE_FN writer,
+    void* handle, char** errormsg)
+  {
+    ZLIBSTREAM*         stream;
+    ZLIBSTART_FN        start;
+
+    TRACE(99, "zlibStreamCreate()", NULL);
+
+    *errormsg = NULL;
+
+    if (codec < 0 ||
+        codec >= ZLIB_CODECS)
+      {
+        *errormsg = "unknown compression type";
+        return NULL;
+      }
+
+    if (deflating)
+      { start = zlibcodec[codec].deflatestart; }
+    else
+      { start = zlibcodec[codec].inflatestart; }
+    if (!start)
+      {   /* the codec is known but was not compiled in */
+        *errormsg = "compression type not supported";
+        return NULL;
+      }
+
+    stream = memAlloc(__FILE__, __LINE__, sizeof(ZLIBSTREAM));
+    stream -> codec = &zlibcodec[codec];
+    stream -> writer = writer;
+    stream -> handle = handle;
+    stream -> finished = 0;
+    stream -> member = NULL;
+
+    if ((start)(stream, errormsg))
+      {
+        memFree(__FILE__, __LINE__, stream, sizeof(ZLIBSTREAM));
+        return NULL;
+      }
+
+    return stream;
+  }
+
+/* #############################################################################
+ *
+ * Description    get the number of threads the compression uses
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      void
+ * Return         number of threads, at least 1
+ */
+int zlibThreads(void)
+  {
+    int                 threads = 1;
+
+    TRACE(99, "zlibThreads()", NULL);
+
+#ifdef HAVE_LIBPTHREAD
+    if (config -> compressionthreads)
+      { threads = config -> compressionthreads; }
+    else
+      {   /* by default we use one thread per processor */
+        threads = sysconf(_SC_NPROCESSORS_ONLN);
+      }
+    threads = max(1, min(threads, ZLIB_MAXTHREADS));
+#endif
+
+    return threads;
+  }
+
+
+/* #############################################################################
+ *
+ * Description    compress the next chunk of a zstd stream and hand the
+ *                compressed data to the writer of the stream
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream from zlibDeflateStart
+ *                const char* buffer  - data to compress
+ *                int size            - length of the data
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+#ifdef HAVE_LIBZSTD
+int zlibZstdDeflateChunk(ZLIBSTREAM* stream, const char* buffer, int size,
+    char** errormsg)
+  {
+    ZSTD_inBuffer       input;
+
+    TRACE(99, "zlibZstdDeflateChunk()", NULL);
+
+    input.src = buffer;
+    input.size = size;
+    input.pos = 0;
+
+    return zlibZstdDeflateFlush(stream, &input, ZSTD_e_continue, errormsg);
+  }
+#endif
+
+/* #############################################################################
+ *
+ * Description    finish a zstd compression stream and write the remaining
+ *                data
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream from zlibDeflateStart
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+#ifdef HAVE_LIBZSTD
+int zlibZstdDeflateEnd(ZLIBSTREAM* stream, char** errormsg)
+  {
+    ZSTD_inBuffer       input;
+    int                 error;
+
+    TRACE(99, "zlibZstdDeflateEnd()", NULL);
+
+    input.src = NULL;
+    input.size = 0;
+    input.pos = 0;
+
+    error = zlibZstdDeflateFlush(stream, &input, ZSTD_e_end, errormsg);
+
+    ZSTD_freeCCtx(stream -> zcctx);
+    memFree(__FILE__, __LINE__, stream -> zbuffer, BUFFERSIZE);
+
+    return error;
+  }
+#endif
+
+/* #############################################################################
+ *
+ * Description    run the zstd compression on the given input until it is
+ *                consumed and pass all output to the writer
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream      - stream from zlibDeflateStart
+ *                ZSTD_inBuffer* input    - data to compress
+ *                ZSTD_EndDirective mode  - ZSTD_e_continue or ZSTD_e_end
+ *                char** errormsg         - error message, if any
+ * Return         1 on error, 0 on success
+ */
+#ifdef HAVE_LIBZSTD
+int zlibZstdDeflateFlush(ZLIBSTREAM* stream, ZSTD_inBuffer* input,
+    ZSTD_EndDirective mode, char** errormsg)
+  {
+    ZSTD_outBuffer      output;
+    size_t              pending;
+
+    TRACE(99, "zlibZstdDeflateFlush()", NULL);
+
+    do
+      {
+        output.dst = stream -> zbuffer;
+        output.size = BUFFERSIZE;
+        output.pos = 0;
+
+        pending = ZSTD_compressStream2(stream -> zcctx, &output, input, mode);
+        if (ZSTD_isError(pending))
+          {
+            *errormsg = (char*)ZSTD_getErrorName(pending);
+            return 1;
+          }
+
+        if (output.pos &&
+            (stream -> writer)(stream -> handle, (char*)stream -> zbuffer,
+                output.pos))
+          {
+            *errormsg = "write error";
+            return 1;
+          }
+      }
+    while (input -> pos < input -> size ||
+        (mode == ZSTD_e_end && pending));
+
+    return 0;
+  }
+#endif
+
+/* #############################################################################
+ *
+ * Description    start the zstd compression of a stream; zstd has no level
+ *                without compression, so level 0 compresses at level 1, and
+ *                the checksum of the frame takes the role of the gzip CRC
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - the new stream
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+#ifdef HAVE_LIBZSTD
+int zlibZstdDeflateStart(ZLIBSTREAM* stream, char** errormsg)
+  {
+    size_t              result;
+    int                 threads;
+
+    TRACE(99, "zlibZstdDeflateStart()", NULL);
+
+    stream -> zcctx = ZSTD_createCCtx();
+    if (!stream -> zcctx)
+      {
+        *errormsg = "out of memory";
+        return 1;
+      }
+
+    result = ZSTD_CCtx_setParameter(stream -> zcctx, ZSTD_c_compressionLevel,
+        max(1, config -> compression));
+    if (!ZSTD_isError(result))
+      {
+        result = ZSTD_CCtx_setParameter(stream -> zcctx, ZSTD_c_checksumFlag,
+            1);
+      }
+    if (ZSTD_isError(result))
+      {
+        *errormsg = (char*)ZSTD_getErrorName(result);
+        ZSTD_freeCCtx(stream -> zcctx);
+        return 1;
+      }
+
+    /* the library only uses the threads if it was built with them */
+    threads = zlibThreads();
+    if (threads > 1)
+      {
+        ZSTD_CCtx_setParameter(stream -> zcctx, ZSTD_c_nbWorkers, threads);
+      }
+
+    stream -> zbuffer = memAlloc(__FILE__, __LINE__, BUFFERSIZE);
+
+    return 0;
+  }
+#endif
+
+/* #############################################################################
+ *
+ * Description    decompress the next chunk of a zstd stream and hand the
+ *                decompressed data to the writer of the stream
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream from zlibInflateStart
+ *                const char* buffer  - compressed data
+ *                int size            - length of the compressed data
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+#ifdef HAVE_LIBZSTD
+int zlibZstdInflateChunk(ZLIBSTREAM* stream, const char* buffer, int size,
+    char** errormsg)
+  {
+    ZSTD_inBuffer       input;
+    ZSTD_outBuffer      output;
+    size_t              result;
+
+    TRACE(99, "zlibZstdInflateChunk()", NULL);
+
+    input.src = buffer;
+    input.size = size;
+    input.pos = 0;
+
+    do
+      {
+        output.dst = stream -> zbuffer;
+        output.size = BUFFERSIZE;
+        output.pos = 0;
+
+        result = ZSTD_decompressStream(stream -> zdctx, &output, &input);
+        if (ZSTD_isError(result))
+          {
+            *errormsg = (char*)ZSTD_getErrorName(result);
+            return 1;
+          }
+
+        /* 0 marks the end of a frame; another one may follow */
+        stream -> finished = !result;
+
+        if (output.pos &&
+            (stream -> writer)(stream -> handle, (char*)stream -> zbuffer,
+                output.pos))
+          {
+            *errormsg = "write error";
+            return 1;
+          }
+      }
+    while (input.pos < input.size ||
+        output.pos == output.size);
+
+    return 0;
+  }
+#endif
+
+/* #############################################################################
+ *
+ * Description    finish a zstd decompression stream
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - stream from zlibInflateStart
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+#ifdef HAVE_LIBZSTD
+int zlibZstdInflateEnd(ZLIBSTREAM* stream, char** errormsg)
+  {
+    TRACE(99, "zlibZstdInflateEnd()", NULL);
+
+    ZSTD_freeDCtx(stream -> zdctx);
+    memFree(__FILE__, __LINE__, stream -> zbuffer, BUFFERSIZE);
+
+    if (!stream -> finished)
+      {   /* the compressed data was truncated */
+        *errormsg = "unexpected end of data";
+        return 1;
+      }
+
+    return 0;
+  }
+#endif
+
+/* #############################################################################
+ *
+ * Description    start the zstd decompression of a stream
+ * Author         agent
+ * Date           2026-10-17
+ * Arguments      ZLIBSTREAM* stream  - the new stream
+ *                char** errormsg     - error message, if any
+ * Return         1 on error, 0 on success
+ */
+#ifdef HAVE_LIBZSTD
+int zlibZstdInflateStart(ZLIBSTREAM* stream, char** errormsg)
+  {
+    TRACE(99, "zlibZstdInflateStart()", NULL);
+
+    stream -> zdctx = ZSTD_createDCtx();
+    if (!stream -> zdctx)
+      {
+        *errormsg = "out of memory";
+        return 1;
+      }
+
+    stream -> zbuffer = memAlloc(__FILE__, __LINE__, BUFFERSIZE);
+
+    return 0;
+  }
+#endif
 #undef BUFFERSIZE
 
 
@@ -23,16 +23,38 @@
 #ifndef CPM_ZLIB_H
 #define CPM_ZLIB_H
 
+/* #############################################################################
+ * global variables
+ */
+#define CODEC_NONE      -1          /* the data is not compressed */
+#define CODEC_UNKNOWN   -2          /* more data is needed to tell */
+#define CODEC_MAGICSIZE 4           /* size of the longest magic number */
+
+typedef struct sZlibStream ZLIBSTREAM;
+typedef int (*ZLIBWRITE_FN) (void* handle, const char* buffer, int size);
+
+
 /* #############################################################################
  * prototypes
  */
 #ifdef TEST_OPTION
   void testCompress(void);
 #endif
+int zlibCodecDetect(const char* buffer, int size);
 int zlibCompress(char* srcbuffer, int srclen, char** dstbuffer, int* dstlen,
     char** errormsg);
 int zlibDecompress(char* srcbuffer, int srclen, char** dstbuffer, int* dstlen,
     char** errormsg);
+int zlibDeflateChunk(ZLIBSTREAM* stream, const char* buffer, int size,
+    char** errormsg);
+int zlibDeflateEnd(ZLIBSTREAM* stream, char** errormsg);
+ZLIBSTREAM* zlibDeflateStart(ZLIBWRITE_FN writer, void* handle,
+    char** errormsg);
+int zlibInflateChunk(ZLIBSTREAM* stream, const char* buffer, int size,
+    char** errormsg);
+int zlibInflateEnd(ZLIBSTREAM* stream, char** errormsg);
+ZLIBSTREAM* zlibInflateStart(int codec, ZLIBWRITE_FN writer, void* handle,
+    char** errormsg);
 
 
 #endif